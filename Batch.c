@@ -0,0 +1,552 @@
+/*---Batch.c---
+ * This module adds a batch mode - solving (or counting the solutions of) many puzzles non-interactively,
+ * without the console prompts and board printing.
+ *
+ * The puzzles are processed by a pipeline of threads:
+ * 	1. The reader (the calling thread) parses the puzzles of the input file (mapped to memory), one at a time.
+ * 	2. A pool of workers solves (or counts) the puzzles - each worker takes the next puzzle that was read,
+ * 	   loads it to a board of its own, and formats its result as an output line.
+ * 	3. The writer writes the results in the order of the input - the result of a puzzle waits in its slot
+ * 	   until the results of all the puzzles before it were written.
+ * Each puzzle has a slot in a window of BATCH_WINDOW slots, from when it is read until its result is written.
+ * The reader waits while the window is full, so the memory used doesn't depend on the size of the input.
+ * The solving functions only use the boards they are given (and not the boards of the game), so the workers
+ * don't share any state but the window.
+ *
+ * A. Private functions:
+ * 	1. readToken()			:	Finds the next word of the input, skipping comments.
+ * 	2. parseNumber()		:	Returns the number a word represents.
+ * 	3. readPuzzle()			:	Reads the next puzzle of the input to a slot.
+ * 	4. formatBoard()		:	Returns a board as an output line, in the format its puzzle was read in.
+ * 	5. processPuzzle()		:	Solves (or counts the solutions of) the puzzle of a slot, and returns its output line.
+ * 	6. batchWorker()			:	The main loop of a worker thread.
+ * 	7. batchWriter()			:	The main loop of the writer thread.
+ *
+ * B. Public functions:
+ * 	1. runBatch()			:	Solves or counts the solutions of all the puzzles of an input file, and writes the results to an output file.
+ * 	2. batchMain()			:	Runs the batch mode with the command line arguments of the program.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "Batch.h"
+#include "Parser.h"
+#include "FileManager.h"
+#include "Solver.h"
+#include "ILP_Solver.h"
+#include "ThreadPool.h"
+
+#define COMPACT_LENGTH		81		/* the length of a puzzle written in a single line (a 9x9 board) */
+#define BATCH_WINDOW		1024	/* the maximal number of puzzles read and not written yet */
+#define SHORT_RESULT_LENGTH	16		/* the length of an output line that is not a board ("no solution" or a number) */
+
+#define IS_DIGIT(ch)		((ch) >= '0' && (ch) <= '9')
+#define IS_SPACE(ch)		((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r' || (ch) == '\v' || (ch) == '\f')
+
+
+/* The position of the reader in the input (mapped to memory) */
+typedef struct batch_input_t {
+	char*			start;		/* the start of the input */
+	char*			pos;		/* the next character to read */
+	char*			end;		/* the end of the input */
+	char*			token;		/* the last word read (to tell the line of a puzzle that is not correctly formatted) */
+} BatchInput;
+
+
+/* A puzzle of the input, from when it is read until its result is written */
+typedef struct batch_slot_t {
+	unsigned int	m;
+	unsigned int	n;
+	unsigned int	compact;	/* TRUE iff the puzzle was written in a single line of 81 characters */
+	unsigned char*	values;		/* values[row*N+col] - the values of the cells (0 for empty), freed once processed */
+	char*			result;		/* the output line of the puzzle (NULL until it is processed) */
+} BatchSlot;
+
+
+/* Shared data of the threads of the pipeline */
+typedef struct batch_pipeline_t {
+	BatchSlot*		slots;		/* slots[i % BATCH_WINDOW] - the slot of the i-th puzzle */
+	unsigned int	mode;		/* BATCH_SOLVE or BATCH_COUNT */
+	FILE*			ofp;		/* the output file (used by the writer only) */
+	unsigned long	numRead;	/* number of puzzles read so far */
+	unsigned long	numTaken;	/* number of puzzles taken by the workers so far */
+	unsigned long	numWritten;	/* number of results written so far */
+	unsigned long	numFailed;	/* number of puzzles the solving method failed on */
+	unsigned int	endOfInput;	/* TRUE once all the puzzles were read (or the input is not correctly formatted) */
+	pthread_mutex_t	lock;		/* protects the counters, endOfInput and the results of the slots */
+	pthread_cond_t	readable;	/* signaled when a puzzle is read, or at the end of the input */
+	pthread_cond_t	processed;	/* signaled when a result is ready, or at the end of the input */
+	pthread_cond_t	written;	/* signaled when a result is written (its slot is free) */
+} BatchPipeline;
+
+
+/********** Private method declarations **********/
+
+unsigned int	readToken(BatchInput*, char**);
+int				parseNumber(char*, unsigned int);
+int				readPuzzle(BatchInput*, BatchSlot*);
+char*			formatBoard(Board*, unsigned int);
+char*			processPuzzle(BatchSlot*, Board*, Board*, unsigned int, unsigned int*);
+void*			batchWorker(void*);
+void*			batchWriter(void*);
+
+/******* End of private method declarations ******/
+
+
+
+/************************* Public methods *************************/
+
+/*
+ * Solves (or counts the solutions of) all the puzzles of an input file, and writes the results to an output file.
+ * Returns TRUE on success, FALSE if a file can't be opened, and INVALID if the input is not correctly formatted
+ * (the results of the puzzles before the badly formatted one are written, and errorLine is set to its line).
+ * The puzzles the solving method failed on (eg. a Gurobi error) are written as "error", and counted in numFailed.
+ *
+ * The puzzles are processed in parallel, by the number of threads set by setNumThreads() (see Solver.h).
+ * Each puzzle is counted by a single thread.
+ *
+ * char*			inputPath	-	The path of the input file.
+ * char*			outputPath	-	The path of the output file.
+ * unsigned int		mode		-	BATCH_SOLVE or BATCH_COUNT.
+ * unsigned long*	errorLine	-	Set to the line of the input which is not correctly formatted (if INVALID is returned).
+ * unsigned long*	numFailed	-	Set to the number of puzzles the solving method failed on.
+ */
+int runBatch(char* inputPath, char* outputPath, unsigned int mode, unsigned long* errorLine, unsigned long* numFailed) {
+	MappedFile		file;
+	BatchInput		input;
+	BatchPipeline	pipeline;
+	pthread_t		*workers, writer;
+	unsigned int	numThreads = getNumThreads();
+	unsigned int	numWorkers = (numThreads == 0) ? tp_numCores() : numThreads;
+	unsigned int	i;
+	int				status;
+
+	if(!mapFile(&file, inputPath)) {
+		return FALSE;
+	}
+	input.start = input.pos = input.token = file.data;
+	input.end = file.data + file.size;
+	pipeline.ofp = fopen(outputPath, "w");
+	if(pipeline.ofp == NULL) {
+		unmapFile(&file);
+		return FALSE;
+	}
+
+	pipeline.slots = (BatchSlot*)calloc(BATCH_WINDOW, sizeof(BatchSlot));
+	workers = (pthread_t*)malloc(numWorkers * sizeof(pthread_t));
+	if(pipeline.slots == NULL || workers == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	pipeline.mode = mode;
+	pipeline.numRead = pipeline.numTaken = pipeline.numWritten = pipeline.numFailed = 0;
+	pipeline.endOfInput = FALSE;
+	pthread_mutex_init(&pipeline.lock, NULL);
+	pthread_cond_init(&pipeline.readable, NULL);
+	pthread_cond_init(&pipeline.processed, NULL);
+	pthread_cond_init(&pipeline.written, NULL);
+
+	/* the puzzles are already processed in parallel - each one is counted by a single thread */
+	setNumThreads(1);
+	for(i = 0; i < numWorkers; i++) {
+		if(pthread_create(&workers[i], NULL, batchWorker, &pipeline) != 0) {
+			printf("Error: pthread_create has failed\n");
+			exit(1);
+		}
+	}
+	if(pthread_create(&writer, NULL, batchWriter, &pipeline) != 0) {
+		printf("Error: pthread_create has failed\n");
+		exit(1);
+	}
+
+	/* read the puzzles (wait while the window is full) */
+	do {
+		pthread_mutex_lock(&pipeline.lock);
+		while(pipeline.numRead - pipeline.numWritten == BATCH_WINDOW) {
+			pthread_cond_wait(&pipeline.written, &pipeline.lock);
+		}
+		pthread_mutex_unlock(&pipeline.lock);
+
+		status = readPuzzle(&input, &pipeline.slots[pipeline.numRead % BATCH_WINDOW]);
+
+		pthread_mutex_lock(&pipeline.lock);
+		if(status == TRUE) {
+			pipeline.numRead++;
+			pthread_cond_signal(&pipeline.readable);
+		}
+		else {
+			pipeline.endOfInput = TRUE;
+			pthread_cond_broadcast(&pipeline.readable);
+			pthread_cond_signal(&pipeline.processed);
+		}
+		pthread_mutex_unlock(&pipeline.lock);
+	} while(status == TRUE);
+
+	for(i = 0; i < numWorkers; i++) {
+		pthread_join(workers[i], NULL);
+	}
+	pthread_join(writer, NULL);
+	setNumThreads(numThreads);
+
+	if(ferror(pipeline.ofp)) {
+		printf("Error: fputs has failed\n");
+		exit(1);
+	}
+	if(status == INVALID) { /* the line of the last word read - the one that is not correctly formatted */
+		*errorLine = 1;
+		for(; input.start < input.token; input.start++) {
+			if(*input.start == '\n') {
+				(*errorLine)++;
+			}
+		}
+	}
+	*numFailed = pipeline.numFailed;
+	unmapFile(&file);
+	fclose(pipeline.ofp);
+	pthread_mutex_destroy(&pipeline.lock);
+	pthread_cond_destroy(&pipeline.readable);
+	pthread_cond_destroy(&pipeline.processed);
+	pthread_cond_destroy(&pipeline.written);
+	free(pipeline.slots[pipeline.numRead % BATCH_WINDOW].values); /* a puzzle that wasn't fully read */
+	free(pipeline.slots);
+	free(workers);
+	return (status == INVALID) ? INVALID : TRUE;
+}
+
+
+/*
+ * Runs the batch mode with the command line arguments of the program, and returns the exit status of the program
+ * (EXIT_SUCCESS iff all the puzzles were processed, and the solving method didn't fail on any of them).
+ * The ilp solver can't be used to solve the puzzles if the program was built without Gurobi - the batch is not run.
+ *
+ * int		argc	-	Number of command line arguments.
+ * char**	argv	-	The command line arguments: the program name, the mode ("solve" or "count"), the input path and the output path.
+ */
+int batchMain(int argc, char** argv) {
+	unsigned int	mode;
+	int				result;
+	unsigned long	errorLine = 0, numFailed = 0;
+
+	if(argc != 4 || (strcmp(argv[1], "solve") != 0 && strcmp(argv[1], "count") != 0)) {
+		printf("Usage: %s <solve|count> <input path> <output path>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	mode = (strcmp(argv[1], "solve") == 0) ? BATCH_SOLVE : BATCH_COUNT;
+	if(mode == BATCH_SOLVE && getSolvingMethod() == ILP && !ilpAvailable()) { /* every puzzle would fail */
+		printf("Error: the ilp solver is not available, the program was built without Gurobi\n");
+		return EXIT_FAILURE;
+	}
+
+	result = runBatch(argv[2], argv[3], mode, &errorLine, &numFailed);
+	if(result == FALSE) {
+		printf("Error: File cannot be opened\n");
+		return EXIT_FAILURE;
+	}
+	if(result == INVALID) {
+		printf("Error: the input file is not correctly formatted (line %lu)\n", errorLine);
+		return EXIT_FAILURE;
+	}
+	if(numFailed > 0) {
+		printf("Error: the solver failed on %lu puzzles (written as \"error\")\n", numFailed);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+/********************** End of public methods *********************/
+
+
+
+/************************* Private methods *************************/
+
+/*
+ * Finds the next word of the input, skipping whitespaces and comments (from a '#' to the end of the line),
+ * and advances the input past it. Returns the length of the word (0 at the end of the input).
+ *
+ * BatchInput*	input	-	The input.
+ * char**		token	-	Set to the start of the word (in the mapped input - it is not null terminated).
+ */
+unsigned int readToken(BatchInput* input, char** token) {
+	while(input->pos < input->end) {
+		if(IS_SPACE(*input->pos)) {
+			input->pos++;
+		}
+		else if(*input->pos == '#') { /* skip the rest of the comment */
+			while(input->pos < input->end && *input->pos != '\n') {
+				input->pos++;
+			}
+		}
+		else {
+			*token = input->token = input->pos;
+			while(input->pos < input->end && !IS_SPACE(*input->pos)) {
+				input->pos++;
+			}
+			return input->pos - *token;
+		}
+	}
+	return 0;
+}
+
+
+/*
+ * Returns the number a word represents (digits only), or INVALID if it is not a number between 0 and MAX_VALUES.
+ *
+ * char*			token	-	The word.
+ * unsigned int		length	-	The length of the word.
+ */
+int parseNumber(char* token, unsigned int length) {
+	unsigned int	i;
+	int				number = 0;
+
+	if(length == 0) {
+		return INVALID;
+	}
+	for(i = 0; i < length; i++) {
+		if(!IS_DIGIT(token[i]) || number > MAX_VALUES) {
+			return INVALID;
+		}
+		number = number*10 + (token[i] - '0');
+	}
+	return (number > MAX_VALUES) ? INVALID : number;
+}
+
+
+/*
+ * Reads the next puzzle of the input to a slot (and allocates its values).
+ * Returns TRUE if a puzzle was read, FALSE at the end of the input, and INVALID if the input is not correctly formatted.
+ *
+ * BatchInput*		input		-	The input.
+ * BatchSlot*		slot		-	A free slot.
+ */
+int readPuzzle(BatchInput* input, BatchSlot* slot) {
+	char*			token;
+	unsigned int	length;
+	int				m, n, value;
+	unsigned int	N, i;
+
+	length = readToken(input, &token);
+	if(length == 0) {
+		return FALSE;
+	}
+
+	slot->compact = (length == COMPACT_LENGTH);
+	if(slot->compact) { /* a single line of 81 characters */
+		m = n = 3;
+	}
+	else { /* the format of saved games - "m n" and the values of the cells */
+		m = parseNumber(token, length);
+		if(m <= 0) { /* not the start of a puzzle */
+			return INVALID;
+		}
+		length = readToken(input, &token);
+		n = parseNumber(token, length);
+		if(n <= 0 || m*n > MAX_VALUES) {
+			return INVALID;
+		}
+	}
+	N = m*n;
+	slot->m = m;
+	slot->n = n;
+	slot->values = (unsigned char*)malloc(N*N * sizeof(unsigned char));
+	if(slot->values == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+
+	if(slot->compact) {
+		for(i = 0; i < COMPACT_LENGTH; i++) {
+			if(token[i] >= '1' && token[i] <= '9') {
+				slot->values[i] = token[i] - '0';
+			}
+			else if(token[i] == '0' || token[i] == '.') {
+				slot->values[i] = 0;
+			}
+			else {
+				return INVALID;
+			}
+		}
+		return TRUE;
+	}
+	for(i = 0; i < N*N; i++) {
+		length = readToken(input, &token);
+		if(length > 1 && token[length-1] == '.') { /* a fixed cell - the dot is ignored */
+			length--;
+		}
+		value = parseNumber(token, length);
+		if(value == INVALID || (unsigned int)value > N) {
+			return INVALID;
+		}
+		slot->values[i] = value;
+	}
+	return TRUE;
+}
+
+
+/*
+ * Returns a board as an output line (allocated) - either as 81 characters, or in the format of saved games
+ * ("m n" and the values of the cells).
+ *
+ * Board*			boardPtr	-	A pointer to a board.
+ * unsigned int		compact		-	TRUE to write 81 characters (for 9x9 boards only).
+ */
+char* formatBoard(Board* boardPtr, unsigned int compact) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	i;
+	char			*line, *end;
+
+	/* "m n", and each value is at most 2 digits and a space */
+	line = (char*)malloc(2*3 + N*N*3 + 2);
+	if(line == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	end = line;
+	if(compact) {
+		for(i = 0; i < N*N; i++) {
+			*end++ = '0' + getCell(boardPtr, i/N, i%N)->value;
+		}
+	}
+	else {
+		end += sprintf(end, "%u %u", boardPtr->m, boardPtr->n);
+		for(i = 0; i < N*N; i++) {
+			end += sprintf(end, " %u", getCell(boardPtr, i/N, i%N)->value);
+		}
+	}
+	strcpy(end, "\n");
+	return line;
+}
+
+
+/*
+ * Solves (or counts the solutions of) the puzzle of a slot, and returns its output line (allocated).
+ * The values of the puzzle are freed. If the solving method fails (eg. a Gurobi error), the line is "error" -
+ * a failure doesn't tell if the puzzle is solvable.
+ *
+ * BatchSlot*		slot		-	The slot of the puzzle.
+ * Board*			board		-	The board of the worker (for the puzzle).
+ * Board*			solution	-	The solution board of the worker.
+ * unsigned int		mode		-	BATCH_SOLVE or BATCH_COUNT.
+ * unsigned int*	failed		-	Set to TRUE iff the solving method failed.
+ */
+char* processPuzzle(BatchSlot* slot, Board* board, Board* solution, unsigned int mode, unsigned int* failed) {
+	unsigned int	N = slot->m * slot->n;
+	unsigned int	i, count;
+	int				solved = FALSE;
+	char*			line;
+
+	initializeBoard(board, slot->m, slot->n);
+	for(i = 0; i < N*N; i++) {
+		if(slot->values[i] > 0) {
+			setCellVal(board, i/N, i%N, slot->values[i]);
+		}
+	}
+	free(slot->values);
+	slot->values = NULL;
+
+	if(mode == BATCH_SOLVE) {
+		initializeBoard(solution, slot->m, slot->n);
+		if(!hasErrors(board)) {
+			solved = solveBoard(board, solution); /* with the solving method (see Solver.h) - -1 on failure */
+		}
+		if(solved == TRUE) {
+			return formatBoard(solution, slot->compact);
+		}
+	}
+	*failed = (solved == -1);
+	line = (char*)malloc(SHORT_RESULT_LENGTH);
+	if(line == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	if(mode == BATCH_SOLVE) {
+		strcpy(line, *failed ? "error\n" : "no solution\n");
+	}
+	else {
+		/* a board with erroneous values has no solutions */
+		count = hasErrors(board) ? 0 : countSolutions(board, NO_LIMIT);
+		sprintf(line, "%u\n", count);
+	}
+	return line;
+}
+
+
+/*
+ * The main loop of a worker thread - processes the puzzles as they are read, until the end of the input.
+ *
+ * void*	arg		-	The pipeline.
+ */
+void* batchWorker(void* arg) {
+	BatchPipeline*	pipeline = (BatchPipeline*)arg;
+	Board			board = {'\0'};			/* the current puzzle */
+	Board			solution = {'\0'};		/* the solution of the current puzzle (solve mode) */
+	BatchSlot*		slot;
+	char*			result;
+	unsigned int	failed;
+
+	while(TRUE) {
+		pthread_mutex_lock(&pipeline->lock);
+		while(pipeline->numTaken == pipeline->numRead && !pipeline->endOfInput) {
+			pthread_cond_wait(&pipeline->readable, &pipeline->lock);
+		}
+		if(pipeline->numTaken == pipeline->numRead) { /* all the puzzles were taken */
+			pthread_mutex_unlock(&pipeline->lock);
+			break;
+		}
+		slot = &pipeline->slots[pipeline->numTaken % BATCH_WINDOW];
+		pipeline->numTaken++;
+		pthread_mutex_unlock(&pipeline->lock);
+
+		failed = FALSE;
+		result = processPuzzle(slot, &board, &solution, pipeline->mode, &failed);
+
+		pthread_mutex_lock(&pipeline->lock);
+		slot->result = result;
+		if(failed) {
+			pipeline->numFailed++;
+		}
+		pthread_cond_signal(&pipeline->processed);
+		pthread_mutex_unlock(&pipeline->lock);
+	}
+
+	freeBoard(&board);
+	freeBoard(&solution);
+	return NULL;
+}
+
+
+/*
+ * The main loop of the writer thread - writes the results in the order of the input, until the end of the input.
+ *
+ * void*	arg		-	The pipeline.
+ */
+void* batchWriter(void* arg) {
+	BatchPipeline*	pipeline = (BatchPipeline*)arg;
+	BatchSlot*		slot;
+
+	while(TRUE) {
+		pthread_mutex_lock(&pipeline->lock);
+		slot = &pipeline->slots[pipeline->numWritten % BATCH_WINDOW];
+		while(slot->result == NULL && !(pipeline->endOfInput && pipeline->numWritten == pipeline->numRead)) {
+			pthread_cond_wait(&pipeline->processed, &pipeline->lock);
+		}
+		if(slot->result == NULL) { /* all the results were written */
+			pthread_mutex_unlock(&pipeline->lock);
+			break;
+		}
+		pthread_mutex_unlock(&pipeline->lock);
+
+		fputs(slot->result, pipeline->ofp);
+		free(slot->result);
+
+		pthread_mutex_lock(&pipeline->lock);
+		slot->result = NULL;
+		pipeline->numWritten++;
+		pthread_cond_signal(&pipeline->written);
+		pthread_mutex_unlock(&pipeline->lock);
+	}
+	return NULL;
+}
+
+/********************** End of private methods *********************/
@@ -0,0 +1,59 @@
+/*---Batch.h---
+ * This module adds a batch mode - solving (or counting the solutions of) many puzzles non-interactively,
+ * without the console prompts and board printing:
+ *
+ * 	sudoku-console solve <input path> <output path>
+ * 	sudoku-console count <input path> <output path>
+ *
+ * The input file is a stream of puzzles, each in one of two formats (the formats may be mixed):
+ * 	1. A single line of 81 characters - a 9x9 board row by row, where '1'-'9' are values and '0' or '.' are empty cells.
+ * 	2. The format of saved games - "m n" followed by the N*N values of the cells (0 for an empty cell, '.' after a value is ignored).
+ * Lines starting with '#' are comments.
+ *
+ * The output file has a line for each puzzle, in the order of the input:
+ * 	solve	-	the solution, in the format of the puzzle (format 2 is written on a single line),
+ * 				"no solution" if the puzzle is not solvable, or "error" if the solving method failed (eg. a Gurobi error).
+ * 	count	-	the number of solutions of the puzzle.
+ *
+ * The module includes 2 functions:
+ * 	1. runBatch()	:	Solves or counts the solutions of all the puzzles of an input file, and writes the results to an output file.
+ * 	2. batchMain()	:	Runs the batch mode with the command line arguments of the program.
+ */
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+/* Batch modes */
+#define BATCH_SOLVE		0	/* write the solution of each puzzle */
+#define BATCH_COUNT		1	/* write the number of solutions of each puzzle */
+
+
+/*
+ * Solves (or counts the solutions of) all the puzzles of an input file, and writes the results to an output file.
+ * Returns TRUE on success, FALSE if a file can't be opened, and INVALID if the input is not correctly formatted
+ * (the results of the puzzles before the badly formatted one are written, and errorLine is set to its line).
+ * The puzzles the solving method failed on (eg. a Gurobi error) are written as "error", and counted in numFailed.
+ *
+ * The puzzles are processed in parallel, by the number of threads set by setNumThreads() (see Solver.h).
+ * Each puzzle is counted by a single thread.
+ *
+ * char*			inputPath	-	The path of the input file.
+ * char*			outputPath	-	The path of the output file.
+ * unsigned int		mode		-	BATCH_SOLVE or BATCH_COUNT.
+ * unsigned long*	errorLine	-	Set to the line of the input which is not correctly formatted (if INVALID is returned).
+ * unsigned long*	numFailed	-	Set to the number of puzzles the solving method failed on.
+ */
+int		runBatch(char*, char*, unsigned int, unsigned long*, unsigned long*);
+
+
+/*
+ * Runs the batch mode with the command line arguments of the program, and returns the exit status of the program
+ * (EXIT_SUCCESS iff all the puzzles were processed, and the solving method didn't fail on any of them).
+ * The ilp solver can't be used to solve the puzzles if the program was built without Gurobi - the batch is not run.
+ *
+ * int		argc	-	Number of command line arguments.
+ * char**	argv	-	The command line arguments: the program name, the mode ("solve" or "count"), the input path and the output path.
+ */
+int		batchMain(int, char**);
+
+#endif /* BATCH_H_ */
@@ -0,0 +1,155 @@
+/*---BucketQueue.c---
+ * An implementation of a bucket priority queue, used by the exhaustive backtracking in Solver.c
+ * in order to choose the empty cell with the least possible values (minimum remaining values).
+ *
+ * Items with the same key are kept in a doubly linked list (a bucket). The links are stored in arrays indexed by item
+ * (no allocations after bq_init()), so the keys of the cells can be updated incrementally whenever a value is assigned,
+ * instead of rescanning the whole board at every step of the search.
+ *
+ * Functions:
+ * 	1. bq_init()		:	Initializes an empty queue.
+ * 	2. bq_free()		:	Frees all allocated space used by a queue.
+ * 	3. bq_contains()	:	Returns TRUE iff an item is in the queue.
+ * 	4. bq_insert()		:	Inserts an item with a given key.
+ * 	5. bq_remove()		:	Removes an item from the queue.
+ * 	6. bq_update()		:	Changes the key of an item in the queue.
+ * 	7. bq_popMin()		:	Removes and returns an item with the minimal key.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "BucketQueue.h"
+
+#define	TRUE	1
+#define FALSE	0
+
+
+/*
+ * Initializes an empty queue.
+ *
+ * BucketQueue*	queue		-	Said queue.
+ * unsigned int	numItems	-	The items of the queue will be 0 to numItems-1.
+ * unsigned int	maxKey		-	The maximal key of an item.
+ */
+void bq_init(BucketQueue* queue, unsigned int numItems, unsigned int maxKey) {
+	unsigned int	i;
+
+	queue->next		= (int*)malloc(numItems * sizeof(int));
+	queue->prev		= (int*)malloc(numItems * sizeof(int));
+	queue->key		= (unsigned int*)malloc(numItems * sizeof(unsigned int));
+	queue->queued	= (unsigned int*)calloc(numItems, sizeof(unsigned int));
+	queue->head		= (int*)malloc((maxKey+1) * sizeof(int));
+	if(queue->next == NULL || queue->prev == NULL || queue->key == NULL || queue->queued == NULL || queue->head == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	for(i = 0; i <= maxKey; i++) {
+		queue->head[i] = BQ_NONE;
+	}
+	queue->maxKey	= maxKey;
+	queue->size		= 0;
+}
+
+
+/*
+ * Frees all allocated space used by a queue.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ */
+void bq_free(BucketQueue* queue) {
+	free(queue->next);
+	free(queue->prev);
+	free(queue->key);
+	free(queue->queued);
+	free(queue->head);
+}
+
+
+/*
+ * Returns TRUE iff an item is in the queue.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item.
+ */
+unsigned int bq_contains(BucketQueue* queue, unsigned int item) {
+	return queue->queued[item];
+}
+
+
+/*
+ * Inserts an item (that is not in the queue) with a given key, as the first item of its bucket.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item.
+ * unsigned int	key		-	The key of the item (between 0 and maxKey).
+ */
+void bq_insert(BucketQueue* queue, unsigned int item, unsigned int key) {
+	queue->key[item]	= key;
+	queue->prev[item]	= BQ_NONE;
+	queue->next[item]	= queue->head[key];
+	if(queue->head[key] != BQ_NONE) {
+		queue->prev[queue->head[key]] = item;
+	}
+	queue->head[key]	= item;
+	queue->queued[item]	= TRUE;
+	queue->size++;
+}
+
+
+/*
+ * Removes an item from the queue (if it is in the queue).
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item.
+ */
+void bq_remove(BucketQueue* queue, unsigned int item) {
+	if(!queue->queued[item]) {
+		return;
+	}
+	if(queue->prev[item] != BQ_NONE) {
+		queue->next[queue->prev[item]] = queue->next[item];
+	}
+	else { /* first item of its bucket */
+		queue->head[queue->key[item]] = queue->next[item];
+	}
+	if(queue->next[item] != BQ_NONE) {
+		queue->prev[queue->next[item]] = queue->prev[item];
+	}
+	queue->queued[item] = FALSE;
+	queue->size--;
+}
+
+
+/*
+ * Changes the key of an item in the queue.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item (assumed to be in the queue).
+ * unsigned int	key		-	The new key of the item (between 0 and maxKey).
+ */
+void bq_update(BucketQueue* queue, unsigned int item, unsigned int key) {
+	if(queue->key[item] == key) { /* nothing to do */
+		return;
+	}
+	bq_remove(queue, item);
+	bq_insert(queue, item, key);
+}
+
+
+/*
+ * Removes and returns an item with the minimal key, or BQ_NONE if the queue is empty.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ */
+int bq_popMin(BucketQueue* queue) {
+	unsigned int	k;
+	int				item;
+
+	if(queue->size == 0) {
+		return BQ_NONE;
+	}
+	for(k = 0; queue->head[k] == BQ_NONE; k++); /* find the first non-empty bucket */
+	item = queue->head[k];
+	bq_remove(queue, item);
+	return item;
+}
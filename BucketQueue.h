@@ -0,0 +1,100 @@
+/*---BucketQueue.h---
+ * An implementation of a bucket priority queue, used by the exhaustive backtracking in Solver.c
+ * in order to choose the empty cell with the least possible values (minimum remaining values).
+ *
+ * The items are the integers 0 to size-1 (cell indices), and each item in the queue has a key between 0 and maxKey
+ * (its number of possible values). Items with the same key are kept in a doubly linked list (bucket),
+ * so inserting, removing and changing the key of an item take O(1) time, and finding the minimum takes O(maxKey) time.
+ *
+ * Functions:
+ * 	1. bq_init()		:	Initializes an empty queue.
+ * 	2. bq_free()		:	Frees all allocated space used by a queue.
+ * 	3. bq_contains()	:	Returns TRUE iff an item is in the queue.
+ * 	4. bq_insert()		:	Inserts an item with a given key.
+ * 	5. bq_remove()		:	Removes an item from the queue.
+ * 	6. bq_update()		:	Changes the key of an item in the queue.
+ * 	7. bq_popMin()		:	Removes and returns an item with the minimal key.
+ */
+
+#ifndef BUCKET_QUEUE_H_
+#define BUCKET_QUEUE_H_
+
+#define	BQ_NONE		(-1)	/* marks "no item" in the links of the buckets */
+
+
+/* A structure for a bucket priority queue */
+typedef struct bucket_queue_t {
+	int*			next;		/* next[i]	-	the next item in the bucket of item i */
+	int*			prev;		/* prev[i]	-	the previous item in the bucket of item i */
+	unsigned int*	key;		/* key[i]	-	the key of item i */
+	unsigned int*	queued;		/* queued[i]-	TRUE iff item i is in the queue */
+	int*			head;		/* head[k]	-	the first item with key k (size: maxKey+1) */
+	unsigned int	maxKey;
+	unsigned int	size;		/* number of items in the queue */
+} BucketQueue;
+
+
+/*
+ * Initializes an empty queue.
+ *
+ * BucketQueue*	queue		-	Said queue.
+ * unsigned int	numItems	-	The items of the queue will be 0 to numItems-1.
+ * unsigned int	maxKey		-	The maximal key of an item.
+ */
+void			bq_init(BucketQueue*, unsigned int, unsigned int);
+
+
+/*
+ * Frees all allocated space used by a queue.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ */
+void			bq_free(BucketQueue*);
+
+
+/*
+ * Returns TRUE iff an item is in the queue.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item.
+ */
+unsigned int	bq_contains(BucketQueue*, unsigned int);
+
+
+/*
+ * Inserts an item (that is not in the queue) with a given key.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item.
+ * unsigned int	key		-	The key of the item (between 0 and maxKey).
+ */
+void			bq_insert(BucketQueue*, unsigned int, unsigned int);
+
+
+/*
+ * Removes an item from the queue (if it is in the queue).
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item.
+ */
+void			bq_remove(BucketQueue*, unsigned int);
+
+
+/*
+ * Changes the key of an item in the queue.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ * unsigned int	item	-	Said item (assumed to be in the queue).
+ * unsigned int	key		-	The new key of the item (between 0 and maxKey).
+ */
+void			bq_update(BucketQueue*, unsigned int, unsigned int);
+
+
+/*
+ * Removes and returns an item with the minimal key, or BQ_NONE if the queue is empty.
+ *
+ * BucketQueue*	queue	-	Said queue.
+ */
+int				bq_popMin(BucketQueue*);
+
+#endif /* BUCKET_QUEUE_H_ */
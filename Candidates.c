@@ -0,0 +1,261 @@
+/*---Candidates.c---
+ *  This module adds a compact representation of a set of cell values, used to store the candidates
+ *  (possible values) of a cell.
+ *  A set is a bitmask: value val (between 1 and N) is in the set iff bit (val-1) is on.
+ *  Replacing the binary arrays of N+1 unsigned ints allocated for every cell, a set is stored inline
+ *  (no allocations) and is counted/intersected a whole word at a time.
+ *
+ * A. Private functions:
+ * 	1. popCount()		:	Returns the number of bits that are on in a word.
+ * 	2. lowestBit()		:	Returns the index of the lowest bit that is on in a (non-zero) word.
+ *
+ * B. Public functions:
+ * 	1. cand_clear()		:	Removes all values from a set.
+ * 	2. cand_fill()		:	Sets a set to contain exactly the values 1 to N.
+ * 	3. cand_add()		:	Adds a value to a set.
+ * 	4. cand_remove()	:	Removes a value from a set.
+ * 	5. cand_contains()	:	Returns TRUE iff a value is in a set.
+ * 	6. cand_count()		:	Returns the number of values in a set.
+ * 	7. cand_intersect()	:	Removes from a set all the values that are not in another set.
+ * 	8. cand_subtract()	:	Removes from a set all the values that are in another set.
+ * 	9. cand_next()		:	Returns the smallest value in a set that is greater than a given value.
+ * 	10. cand_nth()		:	Returns the k'th smallest value in a set.
+ * 	11. cand_union()	:	Adds to a set all the values that are in another set.
+ */
+
+#include "Candidates.h"
+
+
+/********** Private method declarations **********/
+
+unsigned int	popCount(unsigned long);
+unsigned int	lowestBit(unsigned long);
+
+/******* End of private method declarations ******/
+
+
+
+/************************* Public methods *************************/
+
+/*
+ * Removes all values from a set.
+ *
+ * Candidates*	set	-	Said set.
+ */
+void cand_clear(Candidates* set) {
+	unsigned int	w;
+	for(w = 0; w < CAND_WORDS; w++) {
+		set->words[w] = 0;
+	}
+}
+
+
+/*
+ * Sets a set to contain exactly the values 1 to N.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	N	-	The greatest value in the set.
+ */
+void cand_fill(Candidates* set, unsigned int N) {
+	unsigned int	w;
+	for(w = 0; w < CAND_WORDS; w++) {
+		if(N >= (w+1)*CAND_WORD_BITS) {			/* the whole word is in range */
+			set->words[w] = ~0UL;
+		}
+		else if(N > w*CAND_WORD_BITS) {			/* only the lowest (N mod CAND_WORD_BITS) bits are in range */
+			set->words[w] = (1UL << (N - w*CAND_WORD_BITS)) - 1;
+		}
+		else {									/* no values in this word */
+			set->words[w] = 0;
+		}
+	}
+}
+
+
+/*
+ * Adds a value to a set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to be added (between 1 and MAX_VALUES).
+ */
+void cand_add(Candidates* set, unsigned int val) {
+	set->words[(val-1) / CAND_WORD_BITS] |= 1UL << ((val-1) % CAND_WORD_BITS);
+}
+
+
+/*
+ * Removes a value from a set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to be removed (between 1 and MAX_VALUES).
+ */
+void cand_remove(Candidates* set, unsigned int val) {
+	set->words[(val-1) / CAND_WORD_BITS] &= ~(1UL << ((val-1) % CAND_WORD_BITS));
+}
+
+
+/*
+ * Returns TRUE iff a value is in a set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to look for (between 1 and MAX_VALUES).
+ */
+unsigned int cand_contains(Candidates* set, unsigned int val) {
+	return (set->words[(val-1) / CAND_WORD_BITS] >> ((val-1) % CAND_WORD_BITS)) & 1UL;
+}
+
+
+/*
+ * Returns the number of values in a set.
+ *
+ * Candidates*	set	-	Said set.
+ */
+unsigned int cand_count(Candidates* set) {
+	unsigned int	w, count = 0;
+	for(w = 0; w < CAND_WORDS; w++) {
+		count += popCount(set->words[w]);
+	}
+	return count;
+}
+
+
+/*
+ * Removes from a set all the values that are not in another set.
+ *
+ * Candidates*	set		-	The set to be updated.
+ * Candidates*	other	-	The set to intersect with.
+ */
+void cand_intersect(Candidates* set, Candidates* other) {
+	unsigned int	w;
+	for(w = 0; w < CAND_WORDS; w++) {
+		set->words[w] &= other->words[w];
+	}
+}
+
+
+/*
+ * Removes from a set all the values that are in another set.
+ *
+ * Candidates*	set		-	The set to be updated.
+ * Candidates*	other	-	The set of values to remove.
+ */
+void cand_subtract(Candidates* set, Candidates* other) {
+	unsigned int	w;
+	for(w = 0; w < CAND_WORDS; w++) {
+		set->words[w] &= ~other->words[w];
+	}
+}
+
+
+/*
+ * Returns the smallest value in a set that is greater than val, or 0 if there is no such value.
+ * cand_next(set,0) returns the smallest value in the set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to start after (between 0 and MAX_VALUES).
+ */
+unsigned int cand_next(Candidates* set, unsigned int val) {
+	unsigned int	w = val / CAND_WORD_BITS;	/* value val+1 is stored at bit val */
+	unsigned long	word;
+
+	if(w >= CAND_WORDS) {
+		return 0;
+	}
+	word = set->words[w] & (~0UL << (val % CAND_WORD_BITS)); /* ignore the values up to val */
+	while(word == 0) {
+		if(++w == CAND_WORDS) {
+			return 0;
+		}
+		word = set->words[w];
+	}
+	return w*CAND_WORD_BITS + lowestBit(word) + 1;
+}
+
+
+/*
+ * Returns the k'th smallest value in a set (k starts from 1), or 0 if the set has less than k values.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	k	-	The index of the wanted value.
+ */
+unsigned int cand_nth(Candidates* set, unsigned int k) {
+	unsigned int	w, count;
+	unsigned long	word;
+
+	if(k == 0) {
+		return 0;
+	}
+	for(w = 0; w < CAND_WORDS; w++) {
+		word = set->words[w];
+		count = popCount(word);
+		if(k > count) { /* the value is in one of the next words */
+			k -= count;
+			continue;
+		}
+		while(--k > 0) { /* turn off the k-1 lowest bits */
+			word &= word - 1;
+		}
+		return w*CAND_WORD_BITS + lowestBit(word) + 1;
+	}
+	return 0;
+}
+
+
+/*
+ * Adds to a set all the values that are in another set.
+ *
+ * Candidates*	set		-	The set to be updated.
+ * Candidates*	other	-	The set of values to add.
+ */
+void cand_union(Candidates* set, Candidates* other) {
+	unsigned int	w;
+	for(w = 0; w < CAND_WORDS; w++) {
+		set->words[w] |= other->words[w];
+	}
+}
+
+/********************** End of public methods *********************/
+
+
+
+/************************* Private methods *************************/
+
+/*
+ * Returns the number of bits that are on in a word.
+ *
+ * unsigned long	word	-	Said word.
+ */
+unsigned int popCount(unsigned long word) {
+#if defined(__GNUC__)
+	return __builtin_popcountl(word);
+#else
+	unsigned int	count = 0;
+	while(word != 0) {
+		word &= word - 1;	/* turn off the lowest bit */
+		count++;
+	}
+	return count;
+#endif
+}
+
+
+/*
+ * Returns the index of the lowest bit that is on in a word.
+ * pre: word != 0
+ *
+ * unsigned long	word	-	Said word.
+ */
+unsigned int lowestBit(unsigned long word) {
+#if defined(__GNUC__)
+	return __builtin_ctzl(word);
+#else
+	unsigned int	index = 0;
+	while((word & 1UL) == 0) {
+		word >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+/********************** End of private methods *********************/
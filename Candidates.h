@@ -0,0 +1,136 @@
+/*---Candidates.h---
+ *  This module adds a compact representation of a set of cell values, used to store the candidates
+ *  (possible values) of a cell.
+ *  A set is a bitmask: value val (between 1 and N) is in the set iff bit (val-1) is on.
+ *  A single machine word holds all the values of a board with N <= 64 (on 64-bit platforms),
+ *  larger boards use the following words. Thus intersecting two sets is a single AND per word,
+ *  and counting the values of a set is a single popcount per word.
+ *
+ * Functions:
+ * 	1. cand_clear()		:	Removes all values from a set.
+ * 	2. cand_fill()		:	Sets a set to contain exactly the values 1 to N.
+ * 	3. cand_add()		:	Adds a value to a set.
+ * 	4. cand_remove()	:	Removes a value from a set.
+ * 	5. cand_contains()	:	Returns TRUE iff a value is in a set.
+ * 	6. cand_count()		:	Returns the number of values in a set.
+ * 	7. cand_intersect()	:	Removes from a set all the values that are not in another set.
+ * 	8. cand_subtract()	:	Removes from a set all the values that are in another set.
+ * 	9. cand_next()		:	Returns the smallest value in a set that is greater than a given value.
+ * 	10. cand_nth()		:	Returns the k'th smallest value in a set.
+ * 	11. cand_union()	:	Adds to a set all the values that are in another set.
+ */
+
+#include <limits.h>
+
+#ifndef CANDIDATES_H_
+#define CANDIDATES_H_
+
+#define	MAX_VALUES		99	/* cell values are read and printed with at most 2 digits */
+#define CAND_WORD_BITS	(sizeof(unsigned long) * CHAR_BIT)
+#define CAND_WORDS		((MAX_VALUES + CAND_WORD_BITS - 1) / CAND_WORD_BITS)
+
+
+/* A structure for a set of values (between 1 and MAX_VALUES) */
+typedef struct candidates_t {
+	unsigned long	words[CAND_WORDS];	/* bit (val-1)%CAND_WORD_BITS of words[(val-1)/CAND_WORD_BITS] is on iff val is in the set */
+} Candidates;
+
+
+/*
+ * Removes all values from a set.
+ *
+ * Candidates*	set	-	Said set.
+ */
+void			cand_clear(Candidates*);
+
+
+/*
+ * Sets a set to contain exactly the values 1 to N.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	N	-	The greatest value in the set.
+ */
+void			cand_fill(Candidates*, unsigned int);
+
+
+/*
+ * Adds a value to a set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to be added (between 1 and MAX_VALUES).
+ */
+void			cand_add(Candidates*, unsigned int);
+
+
+/*
+ * Removes a value from a set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to be removed (between 1 and MAX_VALUES).
+ */
+void			cand_remove(Candidates*, unsigned int);
+
+
+/*
+ * Returns TRUE iff a value is in a set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to look for (between 1 and MAX_VALUES).
+ */
+unsigned int	cand_contains(Candidates*, unsigned int);
+
+
+/*
+ * Returns the number of values in a set.
+ *
+ * Candidates*	set	-	Said set.
+ */
+unsigned int	cand_count(Candidates*);
+
+
+/*
+ * Removes from a set all the values that are not in another set.
+ *
+ * Candidates*	set		-	The set to be updated.
+ * Candidates*	other	-	The set to intersect with.
+ */
+void			cand_intersect(Candidates*, Candidates*);
+
+
+/*
+ * Removes from a set all the values that are in another set.
+ *
+ * Candidates*	set		-	The set to be updated.
+ * Candidates*	other	-	The set of values to remove.
+ */
+void			cand_subtract(Candidates*, Candidates*);
+
+
+/*
+ * Returns the smallest value in a set that is greater than val, or 0 if there is no such value.
+ * cand_next(set,0) returns the smallest value in the set.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	val	-	The value to start after (between 0 and MAX_VALUES).
+ */
+unsigned int	cand_next(Candidates*, unsigned int);
+
+
+/*
+ * Returns the k'th smallest value in a set (k starts from 1), or 0 if the set has less than k values.
+ *
+ * Candidates*	set	-	Said set.
+ * unsigned int	k	-	The index of the wanted value.
+ */
+unsigned int	cand_nth(Candidates*, unsigned int);
+
+
+/*
+ * Adds to a set all the values that are in another set.
+ *
+ * Candidates*	set		-	The set to be updated.
+ * Candidates*	other	-	The set of values to add.
+ */
+void			cand_union(Candidates*, Candidates*);
+
+#endif /* CANDIDATES_H_ */
@@ -0,0 +1,361 @@
+/*---DLX.c---
+ * This module solves Sudoku boards with Knuth's Algorithm X, implemented with dancing links (DLX).
+ * A board is modeled as an exact cover problem with 4*N*N constraints (columns of the matrix):
+ * 	Cell constraints	:	column r*N + c				-	cell (r,c) has exactly one value.
+ * 	Row constraints		:	column N^2 + r*N + v		-	row r has exactly one cell with value v+1.
+ * 	Column constraints	:	column 2*N^2 + c*N + v		-	column c has exactly one cell with value v+1.
+ * 	Block constraints	:	column 3*N^2 + b*N + v		-	block b has exactly one cell with value v+1.
+ * A row of the matrix is an option - assigning value v+1 to cell (r,c). Filled cells get a single option (their value),
+ * empty cells get an option for each of their possible values. Each option has exactly 4 nodes, one per constraint family.
+ *
+ * The matrix is stored as parallel arrays of indices (instead of linked node structures), all of them allocated at once:
+ * index 0 is the root, indices 1 to 4*N^2 are the column headers, and the rest are the nodes of the options.
+ * The search mimics the recursion of Algorithm X with an explicit array of the chosen options (one per depth).
+ *
+ * A. Private functions:
+ * 	1. buildMatrix()		:	Builds the exact cover matrix of a board.
+ * 	2. freeMatrix()			:	Frees all allocated space used by a matrix.
+ * 	3. cover()				:	Covers a column - removes it and all the options that intersect it from the matrix.
+ * 	4. uncover()			:	Uncovers a column - the exact inverse of cover().
+ * 	5. chooseColumn()		:	Returns the column with the least options.
+ * 	6. search()				:	Algorithm X - counts the exact covers of the matrix.
+ *
+ * B. Public functions:
+ * 	1. dlxNumSolutions()	:	Calculates the number of solutions for a board (up to a limit).
+ * 	2. dlxSolve()			:	Solves a board and updates its solution board (a drop-in replacement of ilpSolve()).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "DLX.h"
+
+#define ROOT	0
+
+/* --------------- Structures --------------- */
+/*
+ * Dancing links matrix. Node i is linked to its neighbours in its option (left[i], right[i])
+ * and in its column (up[i], down[i]).
+ */
+typedef struct dlx_matrix_t {
+	int*			left;
+	int*			right;
+	int*			up;
+	int*			down;
+	int*			column;			/* column[i]	-	the column header of node i */
+	int*			size;			/* size[c]		-	number of options in column c (for column headers only) */
+	int*			option;			/* option[i]	-	the option of node i, encoded as (r*N + c)*N + v */
+	int*			choice;			/* choice[d]	-	a node of the option chosen at depth d of the search (size: N^2) */
+	unsigned int	N;
+} DLXMatrix;
+
+
+/********** Private method declarations **********/
+
+void			buildMatrix(DLXMatrix*, Board*);
+void			freeMatrix(DLXMatrix*);
+void			cover(DLXMatrix*, int);
+void			uncover(DLXMatrix*, int);
+int				chooseColumn(DLXMatrix*);
+unsigned int	search(DLXMatrix*, unsigned int, int*);
+
+/******* End of private method declarations ******/
+
+
+
+/************************* Public methods *************************/
+
+/*
+ * Calculates the number of solutions for a board.
+ * Stops counting once limit solutions were found (if limit > 0), and returns limit.
+ *
+ * Board*			boardPtr	-	A pointer to a game board.
+ * unsigned int		limit		-	The maximal number of solutions to count (0 for no limit).
+ */
+unsigned int dlxNumSolutions(Board* boardPtr, unsigned int limit) {
+	DLXMatrix		dlx;
+	unsigned int	counter;
+
+	buildMatrix(&dlx, boardPtr);
+	counter = search(&dlx, limit, NULL);
+	freeMatrix(&dlx);
+	return counter;
+}
+
+
+/*
+ * Solves a game board and updates its solution board.
+ * return TRUE iff board is solvable (if not - the solution board is not changed).
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ * Board*	solBoardPtr	-	A pointer to the solution board (of the same size). used to update the solution board.
+ */
+int dlxSolve(Board* boardPtr, Board* solBoardPtr) {
+	DLXMatrix		dlx;
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	i;
+	int*			solution;	/* the options of the first solution found (size: N^2) */
+	int				opt;
+	int				solvable;
+
+	solution = (int*)malloc(N*N*sizeof(int));
+	if(solution == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+
+	buildMatrix(&dlx, boardPtr);
+	solvable = (search(&dlx, 1, solution) == 1); /* stop at the first solution */
+	if(solvable) {
+		/* every cell is covered by exactly one option of the solution */
+		for(i = 0; i < N*N; i++) {
+			opt = solution[i];
+			setCellVal(solBoardPtr, opt/(N*N), (opt/N)%N, opt%N + 1);
+		}
+	}
+	freeMatrix(&dlx);
+	free(solution);
+	return solvable ? TRUE : FALSE;
+}
+
+/********************** End of public methods *********************/
+
+
+
+/************************* Private methods *************************/
+
+/*
+ * Builds the exact cover matrix of a board (all allocations are freed by freeMatrix()).
+ *
+ * DLXMatrix*	dlx			-	The matrix to be built.
+ * Board*		boardPtr	-	A pointer to a game board.
+ */
+void buildMatrix(DLXMatrix* dlx, Board* boardPtr) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	numCols = 4*N*N;
+	unsigned int	numOptions = 0;
+	unsigned int	numNodes;
+	unsigned int	r, c, v, k, block;
+	int				cols[4];		/* the 4 constraints covered by the current option */
+	int				node, first;
+	int*			memory;
+	Candidates		possible;
+	Cell*			cell;
+
+	/* count the options of the board */
+	for(r = 0; r < N; r++) {
+		for(c = 0; c < N; c++) {
+			if(getCell(boardPtr,r,c)->value != 0) {
+				numOptions++;
+			}
+			else {
+				cand_fill(&possible, N);
+				cand_subtract(&possible, &boardPtr->rowsUsed[r]);
+				cand_subtract(&possible, &boardPtr->colsUsed[c]);
+				cand_subtract(&possible, &boardPtr->blocksUsed[getBlockIndex(boardPtr,r,c)]);
+				numOptions += cand_count(&possible);
+			}
+		}
+	}
+	numNodes = 1 + numCols + 4*numOptions;
+
+	/* allocate all the arrays at once: 7 arrays of numNodes ints and the choices of the search */
+	memory = (int*)malloc((7*numNodes + N*N)*sizeof(int));
+	if(memory == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	dlx->left	= memory;
+	dlx->right	= dlx->left + numNodes;
+	dlx->up		= dlx->right + numNodes;
+	dlx->down	= dlx->up + numNodes;
+	dlx->column	= dlx->down + numNodes;
+	dlx->size	= dlx->column + numNodes;
+	dlx->option	= dlx->size + numNodes;
+	dlx->choice	= dlx->option + numNodes;
+	dlx->N		= N;
+
+	/* root and column headers: a circular list ordered by index, each column is an empty circular list */
+	for(k = 0; k <= numCols; k++) {
+		dlx->left[k]	= (k == 0) ? (int)numCols : (int)k-1;
+		dlx->right[k]	= (k == numCols) ? ROOT : (int)k+1;
+		dlx->up[k]		= k;
+		dlx->down[k]	= k;
+		dlx->column[k]	= k;
+		dlx->size[k]	= 0;
+	}
+
+	/* options: append each option's 4 nodes to the bottom of their columns */
+	node = numCols + 1;
+	for(r = 0; r < N; r++) {
+		for(c = 0; c < N; c++) {
+			cell = getCell(boardPtr,r,c);
+			block = getBlockIndex(boardPtr,r,c);
+			if(cell->value != 0) {	/* a filled cell has a single option */
+				cand_clear(&possible);
+				cand_add(&possible, cell->value);
+			}
+			else {
+				cand_fill(&possible, N);
+				cand_subtract(&possible, &boardPtr->rowsUsed[r]);
+				cand_subtract(&possible, &boardPtr->colsUsed[c]);
+				cand_subtract(&possible, &boardPtr->blocksUsed[block]);
+			}
+			for(v = cand_next(&possible,0); v != 0; v = cand_next(&possible,v)) {
+				cols[0] = 1 + r*N + c;
+				cols[1] = 1 + N*N + r*N + (v-1);
+				cols[2] = 1 + 2*N*N + c*N + (v-1);
+				cols[3] = 1 + 3*N*N + block*N + (v-1);
+				first = node;
+				for(k = 0; k < 4; k++, node++) {
+					/* link in the option (circular) */
+					dlx->left[node]		= (k == 0) ? first+3 : node-1;
+					dlx->right[node]	= (k == 3) ? first : node+1;
+					/* link at the bottom of the column */
+					dlx->column[node]	= cols[k];
+					dlx->up[node]		= dlx->up[cols[k]];
+					dlx->down[node]		= cols[k];
+					dlx->down[dlx->up[cols[k]]] = node;
+					dlx->up[cols[k]]	= node;
+					dlx->size[cols[k]]++;
+					dlx->option[node]	= (r*N + c)*N + (v-1);
+				}
+			}
+		}
+	}
+}
+
+
+/*
+ * Frees all allocated space used by a matrix.
+ *
+ * DLXMatrix*	dlx	-	Said matrix.
+ */
+void freeMatrix(DLXMatrix* dlx) {
+	free(dlx->left); /* all the arrays share one allocation */
+}
+
+
+/*
+ * Covers a column - removes it from the header list, and removes all the options that intersect it from the other columns.
+ *
+ * DLXMatrix*	dlx	-	Said matrix.
+ * int			col	-	Said column header.
+ */
+void cover(DLXMatrix* dlx, int col) {
+	int	i, j;
+	dlx->right[dlx->left[col]] = dlx->right[col];
+	dlx->left[dlx->right[col]] = dlx->left[col];
+	for(i = dlx->down[col]; i != col; i = dlx->down[i]) {
+		for(j = dlx->right[i]; j != i; j = dlx->right[j]) {
+			dlx->down[dlx->up[j]] = dlx->down[j];
+			dlx->up[dlx->down[j]] = dlx->up[j];
+			dlx->size[dlx->column[j]]--;
+		}
+	}
+}
+
+
+/*
+ * Uncovers a column - the exact inverse of cover() (links are restored in the reverse order).
+ *
+ * DLXMatrix*	dlx	-	Said matrix.
+ * int			col	-	Said column header.
+ */
+void uncover(DLXMatrix* dlx, int col) {
+	int	i, j;
+	for(i = dlx->up[col]; i != col; i = dlx->up[i]) {
+		for(j = dlx->left[i]; j != i; j = dlx->left[j]) {
+			dlx->size[dlx->column[j]]++;
+			dlx->down[dlx->up[j]] = j;
+			dlx->up[dlx->down[j]] = j;
+		}
+	}
+	dlx->right[dlx->left[col]] = col;
+	dlx->left[dlx->right[col]] = col;
+}
+
+
+/*
+ * Returns the column with the least options (Knuth's "S heuristic").
+ * pre: there is at least one column left.
+ *
+ * DLXMatrix*	dlx	-	Said matrix.
+ */
+int chooseColumn(DLXMatrix* dlx) {
+	int	col, best = dlx->right[ROOT];
+	for(col = dlx->right[best]; col != ROOT; col = dlx->right[col]) {
+		if(dlx->size[col] < dlx->size[best]) {
+			best = col;
+			if(dlx->size[best] <= 1) break; /* can't do better */
+		}
+	}
+	return best;
+}
+
+
+/*
+ * Algorithm X - counts the exact covers of the matrix, and stops after limit covers were found (if limit > 0).
+ * The options of the first cover found are stored in solution (ordered by cell), unless solution is NULL.
+ *
+ * DLXMatrix*	dlx			-	Said matrix.
+ * unsigned int	limit		-	The maximal number of covers to count (0 for no limit).
+ * int*			solution	-	An array of size N^2 for the first cover found, or NULL.
+ */
+unsigned int search(DLXMatrix* dlx, unsigned int limit, int* solution) {
+	unsigned int	counter = 0;
+	unsigned int	depth = 0;		/* number of options chosen */
+	unsigned int	advance = TRUE;	/* TRUE - go deeper, FALSE - backtrack */
+	unsigned int	d;
+	int				col, node, j;
+
+	while(TRUE) {
+		if(advance) {
+			if(dlx->right[ROOT] == ROOT) { /* all constraints are covered - found a solution */
+				counter++;
+				if(counter == 1 && solution != NULL) {
+					for(d = 0; d < depth; d++) {
+						solution[dlx->option[dlx->choice[d]] / dlx->N] = dlx->option[dlx->choice[d]];
+					}
+				}
+				if(limit > 0 && counter >= limit) break;
+				advance = FALSE;
+				continue;
+			}
+			col = chooseColumn(dlx);
+			if(dlx->size[col] == 0) { /* a constraint can't be satisfied */
+				advance = FALSE;
+				continue;
+			}
+			/* choose the first option of the column */
+			cover(dlx, col);
+			node = dlx->down[col];
+			dlx->choice[depth++] = node;
+			for(j = dlx->right[node]; j != node; j = dlx->right[j]) {
+				cover(dlx, dlx->column[j]);
+			}
+			continue;
+		}
+
+		/* backtrack: undo the last option and try the next option of its column */
+		if(depth == 0) break; /* all options were tried */
+		node = dlx->choice[--depth];
+		for(j = dlx->left[node]; j != node; j = dlx->left[j]) {
+			uncover(dlx, dlx->column[j]);
+		}
+		col = dlx->column[node];
+		node = dlx->down[node];
+		if(node != col) { /* there is another option */
+			dlx->choice[depth++] = node;
+			for(j = dlx->right[node]; j != node; j = dlx->right[j]) {
+				cover(dlx, dlx->column[j]);
+			}
+			advance = TRUE;
+		}
+		else { /* no more options for this column */
+			uncover(dlx, col);
+		}
+	}
+	return counter;
+}
+
+/********************** End of private methods *********************/
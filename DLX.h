@@ -0,0 +1,40 @@
+/*---DLX.h---
+ * This module solves Sudoku boards with Knuth's Algorithm X, implemented with dancing links (DLX).
+ * A board is modeled as an exact cover problem with 4*N*N constraints - the same constraint families used by the ILP model:
+ * 	Cell constraints	:	each cell has exactly one value.
+ * 	Row constraints		:	each row has exactly one of each value.
+ * 	Column constraints	:	each column has exactly one of each value.
+ * 	Block constraints	:	each block has exactly one of each value.
+ * Each option (a value for a cell that is legal given the board) covers exactly one constraint of each family.
+ *
+ * The module includes 2 functions:
+ * 	1. dlxNumSolutions()	:	Calculates the number of solutions for a board (up to a limit).
+ * 	2. dlxSolve()			:	Solves a board and updates its solution board (a drop-in replacement of ilpSolve()).
+ */
+
+#include "Game.h"
+
+#ifndef DLX_H_
+#define DLX_H_
+
+
+/*
+ * Calculates the number of solutions for a board.
+ * Stops counting once limit solutions were found (if limit > 0), and returns limit.
+ *
+ * Board*			boardPtr	-	A pointer to a game board.
+ * unsigned int		limit		-	The maximal number of solutions to count (0 for no limit).
+ */
+unsigned int	dlxNumSolutions(Board*, unsigned int);
+
+
+/*
+ * Solves a game board and updates its solution board.
+ * return TRUE iff board is solvable (if not - the solution board is not changed).
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ * Board*	solBoardPtr	-	A pointer to the solution board (of the same size). used to update the solution board.
+ */
+int				dlxSolve(Board*, Board*);
+
+#endif /* DLX_H_ */
@@ -2,27 +2,59 @@
  * This module adds the functionality of working with files, ie. saving and loading puzzles to/from files.
  * This functionality is being used in "executeSolve", "executeEdit", and "executeSave" user-commands.
  *
+ * Files are loaded through a memory mapping: the cells are parsed directly from the mapped bytes,
+ * instead of reading them character by character (a library call for each character).
+ *
+ * Puzzles may also be saved in a compact binary format (see FileManager.h) - the whole file is built in memory
+ * and written with a single fwrite().
+ *
  * A. Private functions:
- *  1. fprintfFailureErrorHandling()	:	Prints an error message and closes the given file.
- *  2. markAllErroneousCells()			:	Iterates over all of the given game board and marks all erroneous cells.
+ *  1. fwriteFailureErrorHandling()	:	Prints an error message and closes the given file.
+ *  2. scanNumber()						:	Parses a non-negative number from the contents of a file.
+ *  3. valueBits()						:	Returns the number of bits of a packed value of the binary format.
+ *  4. writeBits()						:	Packs a value to a buffer of bits.
+ *  5. readBits()						:	Unpacks a value from a buffer of bits.
+ *  6. loadBinaryBoard()				:	Loads board to *boardPtr from the contents of a file in the binary format.
+ *  7. checkTextValues()				:	Checks that the cell values of a file in the text format are in range.
  *
  * B. Public functions:
  *  1 - saveBoard()						:	Saves board to given path.
  *  2-  loadBoard()						:	Loads board to *boardPtr from path
+ *  3 - saveBinaryBoard()				:	Saves board to given path in the binary format.
+ *  4 - isBinaryPath()					:	Returns TRUE iff a path has the extension of the binary format.
+ *  5 - mapFile()						:	Maps the contents of a file to memory (read only).
+ *  6 - unmapFile()						:	Frees a file mapped by mapFile().
  */
 
+#define _POSIX_C_SOURCE 200112L	/* for mmap() and posix_madvise() */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
-#include "Parser.h" /* import toInt() function */
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Parser.h" /* import INVALID */
 #include "FileManager.h"
 
+#define IS_DIGIT(ch)	((ch) >= '0' && (ch) <= '9')
+#define IS_SPACE(ch)	((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r' || (ch) == '\v' || (ch) == '\f')
+#define READ_CHUNK		4096	/* initial size of the buffer of a file that can't be mapped */
+
+#define BINARY_HEADER_LENGTH	(BINARY_MAGIC_LENGTH + 4)	/* the magic bytes, version, m, n and flags */
+#define PACKED_SIZE(count,bits)	(((count) * (bits) + 7) / 8)	/* number of bytes of count packed values */
+
 
 /********** Private method declarations **********/
 
-void fprintfFailureErrorHandling(FILE*);
-void markAllErroneousCells(Board*);
+void fwriteFailureErrorHandling(FILE*);
+int scanNumber(char**, char*);
+unsigned int valueBits(unsigned int);
+void writeBits(unsigned char*, unsigned int, unsigned int, unsigned int);
+unsigned int readBits(unsigned char*, unsigned int, unsigned int);
+int loadBinaryBoard(Board*, Board*, MappedFile*, unsigned int);
+int checkTextValues(char*, char*, unsigned int);
 
 /******* End of private method declarations ******/
 
@@ -31,7 +63,7 @@ void markAllErroneousCells(Board*);
 
 /*
  * Saves board to given path path.
- * Returns: TRUE (1) - a successful save, FALSE (0) - Unable to open file on given path, INVALID (-1) - fprintf() error.
+ * Returns: TRUE (1) - a successful save, FALSE (0) - Unable to open file on given path, INVALID (-1) - fwrite() error.
  *
  * Board		board		-	A game board.
  * char*		path		-	The path to which the file will be saved to (including filename and extension).
@@ -41,6 +73,7 @@ int saveBoard(Board board, char* path, unsigned int gameMode) {
 	unsigned int	row, col;
 	unsigned int	N;
 	unsigned int	value;
+	char			*buffer, *pos;
 	FILE 			*ofp;
 
 	ofp = fopen(path, "w");
@@ -48,119 +81,284 @@ int saveBoard(Board board, char* path, unsigned int gameMode) {
 		return FALSE; /* no need to call fclose(), as fopen() failed */
 	}
 
-	/* First line: m n (block size) */
-	if(fprintf(ofp, "%d %d\n", board.m, board.n) < 0) {
-		fprintfFailureErrorHandling(ofp);
-		return INVALID;
+	/* The file is rendered to a single buffer, and written with a single fwrite():
+	 * "m n\n", and for each cell - at most 2 digits, a dot and a separator */
+	N = board.m * board.n;
+	buffer = (char*)malloc((2*3 + 1 + N*N*4) * sizeof(char));
+	if(buffer == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
 	}
+	pos = buffer;
+
+	/* First line: m n (block size) */
+	pos += sprintf(pos, "%d %d\n", board.m, board.n);
 
-	N = board.m * board.n;
 	/* The board itself */
 	for(row = 0; row < N; row++) {
 		for(col = 0; col < N; col++) {
 			value = getCell(&board,row,col)->value;
-			/* print cell value */
-			if(fprintf(ofp, "%d", value) < 0) {
-				fprintfFailureErrorHandling(ofp);
-				return INVALID;
+			/* cell value */
+			if(value >= 10) {
+				*pos++ = '0' + value/10;
 			}
+			*pos++ = '0' + value%10;
 			/* Add a dot - '.', if cell is greater than zero and is fixed or we're in edit mode */
 			if(value > 0 && (gameMode == EDIT || getCell(&board,row,col)->fixed)) {
-				if(fprintf(ofp, ".") < 0) {
-					fprintfFailureErrorHandling(ofp);
-					return INVALID;
-				}
+				*pos++ = '.';
 			}
 			/* Add a space character or a new line if we're in the last column */
-				if(fprintf(ofp, "%c", col==N-1?'\n':' ') < 0){
-					fprintfFailureErrorHandling(ofp);
-					return INVALID;
-				}
+			*pos++ = (col == N-1) ? '\n' : ' ';
 		}
 	}
+
+	if(fwrite(buffer, sizeof(char), pos - buffer, ofp) != (size_t)(pos - buffer)) {
+		fwriteFailureErrorHandling(ofp);
+		free(buffer);
+		return INVALID;
+	}
 	/* Done writing to the file - close it */
 	fclose(ofp);
+	free(buffer);
 	return TRUE;
 }
 
 
 
 /*
- * Loads board to *boardPtr from path.
- * Assumes the file contains valid data and is correctly formatted (as instructed).
+ * Loads board to *boardPtr from path, in either format (text or binary - told apart by the magic bytes).
+ * The solution board is initialized to the size of the loaded board, and holds the solution saved with the puzzle
+ * (binary files only, see saveBinaryBoard()) - or is left empty if the file has no solution, or its solution is not valid.
+ * Returns: TRUE (1) - a successful load, FALSE (0) - Unable to open file on given path, the file doesn't start with
+ * valid block sizes, a cell value is greater than N, or a binary file is not valid (*boardPtr and *solution are not changed).
+ * Assumes the rest of a text file is correctly formatted (as instructed).
  *
  * Board		board		-	A game board.
+ * Board*		solution	-	A pointer to the solution board of the game.
  * char*		path		-	The path to which the file will be saved to (including file name and extension).
  * unsigned int	gameMode	-	The current game mode.
  */
-int loadBoard(Board* boardPtr, char* path, unsigned int gameMode) {
+int loadBoard(Board* boardPtr, Board* solution, char* path, unsigned int gameMode) {
 	unsigned int	row, col;
 	int				m,n;
 	unsigned int	N;
 	unsigned int	value;
-	char			ch;
-	char			str_val[3];
-	FILE			*ifp;
-
-	str_val[2] = '\0';
+	MappedFile		file;
+	char			*pos, *end;
+	int				loaded;
 
-	ifp = fopen(path, "r");
-	if(ifp == NULL) {
-		return FALSE; /* no need to call fclose(), as fopen() failed */
+	if(!mapFile(&file, path)) {
+		return FALSE;
+	}
+	if(file.size >= BINARY_MAGIC_LENGTH && memcmp(file.data, BINARY_MAGIC, BINARY_MAGIC_LENGTH) == 0) {
+		loaded = loadBinaryBoard(boardPtr, solution, &file, gameMode);
+		unmapFile(&file);
+		return loaded;
 	}
+	pos = file.data;
+	end = file.data + file.size;
 
 	/* First, get m and n */
-	if(!fscanf(ifp,"%d",&m)) {
-		printf("Error: fscanf has failed\n");
-		exit(1);
-	}
-	if(!fscanf(ifp,"%d",&n)) {
-		printf("Error: fscanf has failed\n");
-		exit(1);
+	m = scanNumber(&pos, end);
+	n = scanNumber(&pos, end);
+	if(m <= 0 || n <= 0 || m*n > MAX_VALUES || !checkTextValues(pos, end, m*n)) {
+		unmapFile(&file);
+		return FALSE;
 	}
-	/* Then initialize board (space allocation etc.) */
+	/* Then initialize board (space allocation etc.) - a text file has no solution */
 	initializeBoard(boardPtr,m,n);
+	initializeBoard(solution,m,n);
 	/* Scan through the rest of the file to get values of all cells */
 	N = m*n;
 	for(row = 0; row < N; row++) {
 		for(col = 0; col < N; col++) {
-			while((ch = fgetc(ifp)) != EOF && !isdigit(ch)); /* find first digit of a cell's value */
-			if(ferror(ifp)) {
-				printf("Error: fgetc has failed\n");
-				exit(1);
+			while(pos < end && !IS_DIGIT(*pos)) { /* find first digit of a cell's value */
+				pos++;
+			}
+			if(pos == end) {
+				break;
+			}
+			value = *pos++ - '0';
+			if(pos < end && IS_DIGIT(*pos)) { /* has another digit */
+				value = value*10 + (*pos++ - '0');
+			}
+			updatePossibleValues(boardPtr,row,col,value); /* update the values used by the cell's row, column and block (and the erroneous cells) */
+			getCell(boardPtr,row,col)->value = value;
+			if(pos < end && *pos == '.' && gameMode == SOLVE) { /* check if fixed */
+				getCell(boardPtr,row,col)->fixed = TRUE;
+			}
+			if(value > 0) {
+				boardPtr->cellsDisplayed++;
 			}
-			if(ch != EOF) {
-				str_val[0] = ch;
-				if((ch = fgetc(ifp)) != EOF && isdigit(ch)) { /* has another digit */
-					str_val[1] = ch;
-					ch = fgetc(ifp); /* Scan the next digit (look for a '.') */
-				}
-				else { /* only one digit */
-					str_val[1] = '\0';
-				}
-				if(ferror(ifp)) {
-					printf("Error: fgetc has failed\n");
-					exit(1);
-				}
-
-				value = toInt(str_val);
-				getCell(boardPtr,row,col)->value = value;
-				if(ch == '.' && gameMode == SOLVE) { /* check if fixed */
-					getCell(boardPtr,row,col)->fixed = TRUE;
-				}
-				if(value > 0) {
-					boardPtr->cellsDisplayed++;
-				}
+			if(pos < end) { /* the character after the value (a '.' or a separator) */
+				pos++;
+			}
+		}
+	}
+	/* Done reading from the file - unmap it */
+	unmapFile(&file);
+	return TRUE;
+}
+
+
+/*
+ * Saves board to given path in the binary format (with a solution of the puzzle, if one is given).
+ * Returns: TRUE (1) - a successful save, FALSE (0) - Unable to open file on given path, INVALID (-1) - fwrite() error.
+ *
+ * Board*		boardPtr	-	A pointer to a game board.
+ * Board*		solution	-	A pointer to a solution of the board (NULL to save the puzzle without a solution).
+ * char*		path		-	The path to which the file will be saved to (including filename and extension).
+ * unsigned int	gameMode	-	The current game mode.
+ */
+int saveBinaryBoard(Board* boardPtr, Board* solution, char* path, unsigned int gameMode) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	bits = valueBits(N);
+	unsigned int	valuesSize = PACKED_SIZE(N*N, bits);
+	unsigned int	fixedSize = PACKED_SIZE(N*N, 1);
+	unsigned int	size, i;
+	unsigned char	*buffer, *values, *fixed, *solutionValues;
+	Cell*			cell;
+	FILE			*ofp;
+
+	ofp = fopen(path, "wb");
+	if(ofp == NULL) {
+		return FALSE; /* no need to call fclose(), as fopen() failed */
+	}
+
+	size = BINARY_HEADER_LENGTH + valuesSize + fixedSize + (solution != NULL ? valuesSize : 0);
+	buffer = (unsigned char*)calloc(size, sizeof(unsigned char));
+	if(buffer == NULL) {
+		printf("Error: calloc has failed\n");
+		exit(1);
+	}
+	values = buffer + BINARY_HEADER_LENGTH;
+	fixed = values + valuesSize;
+	solutionValues = fixed + fixedSize;
+
+	/* The header */
+	memcpy(buffer, BINARY_MAGIC, BINARY_MAGIC_LENGTH);
+	buffer[BINARY_MAGIC_LENGTH] = BINARY_VERSION;
+	buffer[BINARY_MAGIC_LENGTH + 1] = boardPtr->m;
+	buffer[BINARY_MAGIC_LENGTH + 2] = boardPtr->n;
+	buffer[BINARY_MAGIC_LENGTH + 3] = (solution != NULL) ? BINARY_HAS_SOLUTION : 0;
+
+	/* The cells (a cell is fixed if it's fixed or we're in edit mode, like the dots of the text format) */
+	for(i = 0; i < N*N; i++) {
+		cell = getCell(boardPtr, i/N, i%N);
+		writeBits(values, i*bits, cell->value, bits);
+		if(cell->value > 0 && (gameMode == EDIT || cell->fixed)) {
+			writeBits(fixed, i, 1, 1);
+		}
+		if(solution != NULL) {
+			writeBits(solutionValues, i*bits, getCell(solution, i/N, i%N)->value, bits);
+		}
+	}
+
+	if(fwrite(buffer, sizeof(unsigned char), size, ofp) != size) {
+		fwriteFailureErrorHandling(ofp);
+		free(buffer);
+		return INVALID;
+	}
+	/* Done writing to the file - close it */
+	fclose(ofp);
+	free(buffer);
+	return TRUE;
+}
+
+
+/*
+ * Returns TRUE iff a path has the extension of the binary format (BINARY_EXTENSION).
+ *
+ * char*		path		-	Said path.
+ */
+unsigned int isBinaryPath(char* path) {
+	unsigned int	length = strlen(path);
+	unsigned int	extensionLength = strlen(BINARY_EXTENSION);
+
+	return length > extensionLength && strcmp(path + length - extensionLength, BINARY_EXTENSION) == 0;
+}
+
+
+/*
+ * Maps the contents of the file on the given path to memory (read only).
+ * Files that can't be mapped (eg. pipes) are read to an allocated buffer instead.
+ * Returns TRUE on success, FALSE if the file can't be opened (or is a directory).
+ *
+ * MappedFile*	file	-	Said mapping (the contents are valid until unmapFile() is called).
+ * char*		path	-	The path of the file.
+ */
+int mapFile(MappedFile* file, char* path) {
+	int				fd;
+	struct stat		info;
+	void*			data;
+	size_t			capacity = 0;
+	ssize_t			count;
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		return FALSE;
+	}
+	if(fstat(fd, &info) < 0 || S_ISDIR(info.st_mode)) {
+		close(fd);
+		return FALSE;
+	}
+	file->data = NULL;
+	file->size = 0;
+	file->mapped = FALSE;
+
+	if(S_ISREG(info.st_mode) && info.st_size > 0) {
+		data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data != MAP_FAILED) {
+			posix_madvise(data, info.st_size, POSIX_MADV_SEQUENTIAL); /* only a hint - the result is ignored */
+			file->data = (char*)data;
+			file->size = info.st_size;
+			file->mapped = TRUE;
+			close(fd); /* the mapping stays valid */
+			return TRUE;
+		}
+	}
+
+	/* the file can't be mapped - read all of it */
+	while(TRUE) {
+		if(file->size == capacity) {
+			capacity = (capacity == 0) ? READ_CHUNK : 2*capacity;
+			file->data = (char*)realloc(file->data, capacity);
+			if(file->data == NULL) {
+				printf("Error: realloc has failed\n");
+				exit(1);
 			}
 		}
+		count = read(fd, file->data + file->size, capacity - file->size);
+		if(count < 0) {
+			printf("Error: read has failed\n");
+			exit(1);
+		}
+		if(count == 0) {
+			break;
+		}
+		file->size += count;
 	}
-	/* Done reading from the file - close it */
-	fclose(ifp);
-	/* Check for erroneous cells */
-	markAllErroneousCells(boardPtr);
+	close(fd);
 	return TRUE;
 }
 
+
+/*
+ * Frees a file mapped by mapFile().
+ *
+ * MappedFile*	file	-	Said mapping.
+ */
+void unmapFile(MappedFile* file) {
+	if(file->mapped) {
+		munmap(file->data, file->size);
+	}
+	else {
+		free(file->data);
+	}
+	file->data = NULL;
+	file->size = 0;
+}
+
 /********************** End of public methods *********************/
 
 
@@ -169,73 +367,215 @@ int loadBoard(Board* boardPtr, char* path, unsigned int gameMode) {
 
 /*
  * Prints an error message and closes the given file.
- * Assumes fprintf failure.
+ * Assumes fwrite failure.
  *
  * FILE*	file	-	The given file needed to be closed.
  */
-void fprintfFailureErrorHandling(FILE* file) {
-	printf("Error: fprintf has failed\n");
+void fwriteFailureErrorHandling(FILE* file) {
+	printf("Error: fwrite has failed\n");
 	fclose(file);
 }
 
 
+/*
+ * Parses a non-negative number (after optional whitespaces) from the contents of a file, and advances *pos past it.
+ * Returns the number, or INVALID if there is no number at *pos.
+ *
+ * char**	pos		-	A pointer to the current position in the contents.
+ * char*	end		-	The end of the contents.
+ */
+int scanNumber(char** pos, char* end) {
+	int		number = 0;
+	char*	start;
+
+	while(*pos < end && IS_SPACE(**pos)) {
+		(*pos)++;
+	}
+	start = *pos;
+	while(*pos < end && IS_DIGIT(**pos) && number <= MAX_VALUES) {
+		number = number*10 + (**pos - '0');
+		(*pos)++;
+	}
+	return (*pos == start) ? INVALID : number;
+}
+
+
 
 /*
- * Iterates over all of the given game board and marks all erroneous cells.
+ * Returns the number of bits of a packed value of the binary format - the minimal number of bits for a value
+ * between 0 and N.
  *
- * Board*	boardPtr	-	The given board pointer.
+ * unsigned int	N	-	The number of values of the board.
  */
-void markAllErroneousCells(Board* boardPtr) {
-	unsigned int	row, col;
-	unsigned int	i,j, count_i, count_j;
-	unsigned int	m = boardPtr->m, n = boardPtr->n;
-	unsigned int	N = m*n;
-	unsigned int	val;
-	Cell			*curCell, *otherCell;
+unsigned int valueBits(unsigned int N) {
+	unsigned int	bits = 1;
 
-	for(row = 0; row < N; row++) {
-		for(col = 0; col < N; col++) {
-			curCell = getCell(boardPtr,row,col);
-			val = curCell->value; /* current cell's value */
-			if(val == 0 || curCell->isErroneous) { /* cell can't be erroneous if empty */
-				continue; /* continue to next cell */
-			}
-			/* Row */
-			for(j = 0; j < N; j++) {
-				if(j == col) continue;
-				otherCell = getCell(boardPtr,row,j);
-				if(otherCell->value == val) { /* both cells are erroneous (whether the cells are fixed or not is irrelevant) */
-					curCell->isErroneous 	= TRUE;
-					otherCell->isErroneous 	= TRUE;
-				}
-			}
+	while((1U << bits) <= N) {
+		bits++;
+	}
+	return bits;
+}
+
+
+/*
+ * Packs a value to a buffer of bits (from the least significant bit of each byte).
+ * Assumes the bits of the value are clear in the buffer.
+ *
+ * unsigned char*	buffer		-	Said buffer.
+ * unsigned int		position	-	The index of the first bit of the value.
+ * unsigned int		value		-	The value.
+ * unsigned int		bits		-	The number of bits of the value.
+ */
+void writeBits(unsigned char* buffer, unsigned int position, unsigned int value, unsigned int bits) {
+	unsigned int	i;
+
+	for(i = 0; i < bits; i++, position++) {
+		if(value & (1U << i)) {
+			buffer[position / 8] |= 1U << (position % 8);
+		}
+	}
+}
+
+
+/*
+ * Unpacks a value from a buffer of bits (from the least significant bit of each byte).
+ *
+ * unsigned char*	buffer		-	Said buffer.
+ * unsigned int		position	-	The index of the first bit of the value.
+ * unsigned int		bits		-	The number of bits of the value.
+ */
+unsigned int readBits(unsigned char* buffer, unsigned int position, unsigned int bits) {
+	unsigned int	i;
+	unsigned int	value = 0;
+
+	for(i = 0; i < bits; i++, position++) {
+		if(buffer[position / 8] & (1U << (position % 8))) {
+			value |= 1U << i;
+		}
+	}
+	return value;
+}
+
+
+/*
+ * Loads board to *boardPtr from the contents of a file in the binary format, and the solution saved with it (if any)
+ * to *solution. The solution is kept only if it is a valid solution of the puzzle - complete, with no erroneous cells,
+ * and agrees with the values of the puzzle - otherwise the solution board is left empty.
+ * Returns TRUE on success, FALSE if the contents are not valid (*boardPtr and *solution are not changed).
+ *
+ * Board*		boardPtr	-	A pointer to a game board.
+ * Board*		solution	-	A pointer to the solution board of the game.
+ * MappedFile*	file		-	The contents of the file (starting with the magic bytes).
+ * unsigned int	gameMode	-	The current game mode.
+ */
+int loadBinaryBoard(Board* boardPtr, Board* solution, MappedFile* file, unsigned int gameMode) {
+	unsigned char*	data = (unsigned char*)file->data;
+	unsigned char	*values, *fixed, *solutionValues = NULL;
+	unsigned int	m, n, N, bits, i;
+	unsigned int	valuesSize, fixedSize, size;
+	unsigned int	value, solutionValue;
+	Cell*			cell;
+
+	/* The header */
+	if(file->size < BINARY_HEADER_LENGTH || data[BINARY_MAGIC_LENGTH] != BINARY_VERSION) {
+		return FALSE;
+	}
+	m = data[BINARY_MAGIC_LENGTH + 1];
+	n = data[BINARY_MAGIC_LENGTH + 2];
+	if(m == 0 || n == 0 || m*n > MAX_VALUES) {
+		return FALSE;
+	}
+	N = m*n;
+	bits = valueBits(N);
+	valuesSize = PACKED_SIZE(N*N, bits);
+	fixedSize = PACKED_SIZE(N*N, 1);
+	size = BINARY_HEADER_LENGTH + valuesSize + fixedSize;
+	if(data[BINARY_MAGIC_LENGTH + 3] & BINARY_HAS_SOLUTION) {
+		size += valuesSize;
+	}
+	if(file->size < size) {
+		return FALSE;
+	}
+	values = data + BINARY_HEADER_LENGTH;
+	fixed = values + valuesSize;
+	if(data[BINARY_MAGIC_LENGTH + 3] & BINARY_HAS_SOLUTION) {
+		solutionValues = fixed + fixedSize;
+	}
 
-			/* Column */
-			for(i = 0; i < N; i++) {
-				if(i == row) continue;
-				otherCell = getCell(boardPtr,i,col);
-				if(otherCell->value == val) { /* both cells are erroneous (whether the cells are fixed or not is irrelevant) */
-					curCell->isErroneous 	= TRUE;
-					otherCell->isErroneous 	= TRUE;
-				}
+	/* Check the values before changing the board - a solution must fill every cell, and keep the values of the puzzle */
+	for(i = 0; i < N*N; i++) {
+		value = readBits(values, i*bits, bits);
+		if(value > N) {
+			return FALSE;
+		}
+		if(solutionValues != NULL) {
+			solutionValue = readBits(solutionValues, i*bits, bits);
+			if(solutionValue == 0 || solutionValue > N || (value > 0 && value != solutionValue)) {
+				solutionValues = NULL;
 			}
+		}
+	}
 
-			/* Block */
-			i = m*((row)/m); /* Index of the first row of the block */
-			j = n*((col)/n); /* Index of the first column of the block */
-			for(count_i = 0; count_i < m; count_i++) {
-				for(count_j = 0; count_j < n; count_j++) {
-					if(i+count_i == row && j+count_j == col) continue;
-					otherCell = getCell(boardPtr,i+count_i,j+count_j);
-					if(otherCell->value == val) { /* both cells are erroneous (whether the cells are fixed or not is irrelevant) */
-						curCell->isErroneous 	= TRUE;
-						otherCell->isErroneous 	= TRUE;
-					}
-				}
+	initializeBoard(boardPtr, m, n);
+	initializeBoard(solution, m, n);
+	for(i = 0; i < N*N; i++) {
+		value = readBits(values, i*bits, bits);
+		if(value > 0) {
+			cell = getCell(boardPtr, i/N, i%N);
+			updatePossibleValues(boardPtr, i/N, i%N, value); /* update the values used by the cell's row, column and block (and the erroneous cells) */
+			cell->value = value;
+			if(gameMode == SOLVE && readBits(fixed, i, 1)) {
+				cell->fixed = TRUE;
 			}
+			boardPtr->cellsDisplayed++;
 		}
 	}
-	return;
+	if(solutionValues != NULL) {
+		for(i = 0; i < N*N; i++) {
+			value = readBits(solutionValues, i*bits, bits);
+			updatePossibleValues(solution, i/N, i%N, value);
+			getCell(solution, i/N, i%N)->value = value;
+		}
+		solution->cellsDisplayed = N*N;
+		if(hasErrors(solution)) { /* not a solution - the puzzle is loaded without it */
+			nullifyBoard(solution);
+		}
+	}
+	return TRUE;
 }
 
+
+
+/*
+ * Checks that the cell values of a file in the text format (the N*N values after the block sizes) are between 0 and N.
+ * The values are parsed like loadBoard() does, so the board is not changed when the file is rejected.
+ * Returns TRUE iff all the values are in range.
+ *
+ * char*			pos		-	The position of the first cell value in the contents.
+ * char*			end		-	The end of the contents.
+ * unsigned int		N		-	The number of values of the board.
+ */
+int checkTextValues(char* pos, char* end, unsigned int N) {
+	unsigned int	cell, value;
+
+	for(cell = 0; cell < N*N; cell++) {
+		while(pos < end && !IS_DIGIT(*pos)) { /* find first digit of a cell's value */
+			pos++;
+		}
+		if(pos == end) {
+			break;
+		}
+		value = *pos++ - '0';
+		if(pos < end && IS_DIGIT(*pos)) { /* has another digit */
+			value = value*10 + (*pos++ - '0');
+		}
+		if(value > N) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+
+
 /********************** End of private methods *********************/
@@ -2,16 +2,54 @@
  * This module adds the functionality of working with files, ie. saving and loading puzzles to/from files.
  * This functionality is being used in "executeSolve", "executeEdit", and "executeSave" user-commands.
  *
- * The module includes 2 functions:
- * 1 - saveBoard()	:	Saves board to given path.
- * 2-  loadBoard()	:	Loads board to *boardPtr from path
+ * Files are read through a memory mapping (see mapFile()) and parsed directly from the mapped bytes.
+ *
+ * Puzzles are saved either as text (the format of the assignment), or - to paths with the BINARY_EXTENSION -
+ * in a compact binary format. loadBoard() tells the formats apart by the magic bytes at the start of the file.
+ * The binary format (all sizes in bytes):
+ * 	4		-	the magic bytes "SDKB".
+ * 	1		-	the version of the format (BINARY_VERSION).
+ * 	1 + 1	-	m and n (the block sizes).
+ * 	1		-	flags (BINARY_HAS_SOLUTION).
+ * 	then	-	the values of the cells, row by row, packed with the minimal number of bits for a value between 0 and N.
+ * 	then	-	a bit for each cell, row by row - set iff the cell is fixed.
+ * 	then	-	(only if BINARY_HAS_SOLUTION) the values of a solution of the puzzle, packed as the values of the cells.
+ * The bits are packed in each byte from the least significant bit, and each part starts at a new byte.
+ * A solution saved with a puzzle is loaded to the solution board of the game, so the puzzle is not solved again.
+ *
+ * The module includes 6 functions:
+ * 1 - saveBoard()			:	Saves board to given path.
+ * 2-  loadBoard()			:	Loads board to *boardPtr from path
+ * 3 - saveBinaryBoard()	:	Saves board to given path in the binary format.
+ * 4 - isBinaryPath()		:	Returns TRUE iff a path has the extension of the binary format.
+ * 5 - mapFile()			:	Maps the contents of a file to memory (read only).
+ * 6 - unmapFile()			:	Frees a file mapped by mapFile().
  */
 
+#include <stddef.h>
 #include "Game.h"
 
+#ifndef FILE_MANAGER_H_
+#define FILE_MANAGER_H_
+
+/* The binary format */
+#define BINARY_EXTENSION	".sdb"	/* puzzles are saved in the binary format to paths with this extension */
+#define BINARY_MAGIC		"SDKB"
+#define BINARY_MAGIC_LENGTH	4
+#define BINARY_VERSION		1
+#define BINARY_HAS_SOLUTION	1		/* a flag - the file includes a solution of the puzzle */
+
+/* A structure for the contents of a file, mapped to memory (read only) */
+typedef struct mapped_file_t {
+	char*			data;		/* the contents of the file (not null terminated) */
+	size_t			size;		/* number of bytes in data */
+	unsigned int	mapped;		/* TRUE iff data is a memory mapping (otherwise it was read to an allocated buffer) */
+} MappedFile;
+
+
 /*
  * Saves board to given path path.
- * Returns: TRUE (1) - a successful save, FALSE (0) - Unable to open file on given path, INVALID (-1) - fprintf() error.
+ * Returns: TRUE (1) - a successful save, FALSE (0) - Unable to open file on given path, INVALID (-1) - fwrite() error.
  *
  * Board		board		-	A game board.
  * char*		path		-	The path to which the file will be saved to (including filename and extension).
@@ -21,11 +59,57 @@ int	saveBoard(Board, char*, unsigned int);
 
 
 /*
- * Loads board to *boardPtr from path.
- * Assumes the file contains valid data and is correctly formatted (as instructed).
+ * Loads board to *boardPtr from path, in either format (text or binary - told apart by the magic bytes).
+ * The solution board is initialized to the size of the loaded board, and holds the solution saved with the puzzle
+ * (binary files only, see saveBinaryBoard()) - or is left empty if the file has no solution, or its solution is not valid.
+ * Returns: TRUE (1) - a successful load, FALSE (0) - Unable to open file on given path, the file doesn't start with
+ * valid block sizes, a cell value is greater than N, or a binary file is not valid (*boardPtr and *solution are not changed).
+ * Assumes the rest of a text file is correctly formatted (as instructed).
  *
  * Board		board		-	A game board.
+ * Board*		solution	-	A pointer to the solution board of the game.
  * char*		path		-	The path to which the file will be saved to (including file name and extension).
  * unsigned int	gameMode	-	The current game mode.
  */
-int				loadBoard(Board*, char*, unsigned int);
+int				loadBoard(Board*, Board*, char*, unsigned int);
+
+
+/*
+ * Saves board to given path in the binary format (with a solution of the puzzle, if one is given).
+ * Returns: TRUE (1) - a successful save, FALSE (0) - Unable to open file on given path, INVALID (-1) - fwrite() error.
+ *
+ * Board*		boardPtr	-	A pointer to a game board.
+ * Board*		solution	-	A pointer to a solution of the board (NULL to save the puzzle without a solution).
+ * char*		path		-	The path to which the file will be saved to (including filename and extension).
+ * unsigned int	gameMode	-	The current game mode.
+ */
+int				saveBinaryBoard(Board*, Board*, char*, unsigned int);
+
+
+/*
+ * Returns TRUE iff a path has the extension of the binary format (BINARY_EXTENSION).
+ *
+ * char*		path		-	Said path.
+ */
+unsigned int	isBinaryPath(char*);
+
+
+/*
+ * Maps the contents of the file on the given path to memory (read only).
+ * Files that can't be mapped (eg. pipes) are read to an allocated buffer instead.
+ * Returns TRUE on success, FALSE if the file can't be opened (or is a directory).
+ *
+ * MappedFile*	file	-	Said mapping (the contents are valid until unmapFile() is called).
+ * char*		path	-	The path of the file.
+ */
+int				mapFile(MappedFile*, char*);
+
+
+/*
+ * Frees a file mapped by mapFile().
+ *
+ * MappedFile*	file	-	Said mapping.
+ */
+void			unmapFile(MappedFile*);
+
+#endif /* FILE_MANAGER_H_ */
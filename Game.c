@@ -11,10 +11,16 @@
  * 	2. getHint()				:	Given a column and row of a cell - returns the solution value of the cell
  * 	3. isCellFixed()			:	Given a column and row of a cell - return TRUE iff cell is fixed
  *     								in boardPtr->board.
- * 	4. isErroneous()			:	Checks if cell[row][col] of boardPtr->board contains an erroneous value.
- * 	5. updatePossibleValues()	:	Given a row a column and a new value, updates the possible values for the row
+ * 	4. isErroneous()			:	Checks if cell[row][col] of boardPtr->board contains an erroneous value (in O(1) time).
+ * 	5. updatePossibleValues()	:	Given a row a column and a new value, updates the values used by the row
  *     								column, and block.
  * 	6. setCellVal()				:	Assigns value to a cell, and update other variables as necessary.
+ * 	7. placeCellVal()			:	Assigns value to a cell of a board without erroneous cells, updating only the used values.
+ * 	8. getBlockIndex()			:	Returns the index of the block that contains a cell.
+ * 	9. addValueCount()			:	Private. Adds an occurrence of a value to a row, column or block.
+ * 	10. removeValueCount()		:	Private. Removes an occurrence of a value from a row, column or block.
+ * 	11. boardSize()				:	Private. Returns the size of the single allocation holding a board's cells, used values and value counts.
+ * 	12. trackSolution()			:	Private. Updates the state of the solution cache after a cell of a board changed.
  *
  *
  * B. Board functions:
@@ -26,17 +32,18 @@
  * 	5. copyBoard()				:	Copies the contents of the original board to the copied board.
  * 	6. getGameBoardPtr()		:	Returns a pointer to gameBoard
  * 	7. getSolutionBoardPtr()	:	Returns a pointer to solutionBoard.
- *  8. hasErrors()				:	Checks if boardPtr->board has any erroneous cells.
+ *  8. hasErrors()				:	Checks if boardPtr->board has any erroneous cells (in O(1) time).
  *
  *
  * C. Game functions:
  * 	1. initializeGame()			:	Initializes a new empty game board and a solution board,
  * 	   								frees previously allocated space used by these boards.
- * 	2. updateErroneous()		:	Updates all cells that may have changed from erroneous to not erroneous or the other way around.
- *  3. setGameMode()			:	Sets the value of gameMode to a new Game Mode.
- *  4. getGameMode()			:	Returns the value of gameMode.
- *  5. setMarkErrors()			:	Sets the value of markErrors to mark (assumes mark is 0 or 1).
- *  6. getMarkErrors()			:	Returns the value of markErrors.
+ *  2. setGameMode()			:	Sets the value of gameMode to a new Game Mode.
+ *  3. getGameMode()			:	Returns the value of gameMode.
+ *  4. setMarkErrors()			:	Sets the value of markErrors to mark (assumes mark is 0 or 1).
+ *  5. getMarkErrors()			:	Returns the value of markErrors.
+ *  6. isSolutionCurrent()		:	Returns TRUE iff solutionBoard holds a solution of gameBoard.
+ *  7. setSolutionCurrent()		:	Marks solutionBoard as a solution of gameBoard.
  *
  *
  * D. Move-list functions:
@@ -50,6 +57,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "Game.h"
 
 
@@ -60,6 +68,18 @@ DoublyLinkedList	*moveList;					/* a doubly linked list containing all moves don
 DoublyNode			*curMove;					/* a pointer to the current move the user is at */
 unsigned int		gameMode;					/* current game mode (init / solve / edit). */
 unsigned int		markErrors = TRUE;			/* a binary variable indicating that the player wants to mark erroneous cells (with an asterisk). */
+unsigned int		solutionCached = FALSE;		/* TRUE iff solutionBoard was a solution of gameBoard when it was last validated */
+unsigned int		solutionMismatches = 0;		/* the number of filled cells of gameBoard whose value differs from solutionBoard since */
+
+
+/********** Private method declarations **********/
+
+void			addValueCount(Board*, unsigned char*, Candidates*, unsigned int);
+void			removeValueCount(Board*, unsigned char*, Candidates*, unsigned int);
+size_t			boardSize(unsigned int);
+void			trackSolution(Board*, unsigned int, unsigned int, unsigned int, unsigned int);
+
+/******* End of private method declarations ******/
 
 
 
@@ -74,7 +94,7 @@ unsigned int		markErrors = TRUE;			/* a binary variable indicating that the play
  * unsigned int col		-	Column number (between 0 and N-1).
  */
 Cell* getCell(Board* boardPtr, unsigned int row, unsigned int col) {
-	return &(boardPtr->board[row][col]);
+	return &(boardPtr->cells[row * boardPtr->m * boardPtr->n + col]);
 }
 
 
@@ -85,7 +105,7 @@ Cell* getCell(Board* boardPtr, unsigned int row, unsigned int col) {
  * unsigned int row		-	Row number (between 0 and N-1).
  */
 unsigned int getHint(unsigned int row, unsigned int col) {
-	return solutionBoard.board[row][col].value;
+	return getCell(&solutionBoard, row, col)->value;
 }
 
 
@@ -102,60 +122,30 @@ unsigned int isCellFixed(Board* boardPtr, unsigned int row, unsigned int col) {
 
 
 /*
- * Checks if cell[row][col] of boardPtr->board contains an erroneous value.
+ * Checks if cell[row][col] of boardPtr->board contains an erroneous value,
+ * ie. if its row, column or block contains its value more than once.
  *
  * Board*	boardPtr	-	A pointer to a game board.
  * unsigned int	row		-	Row number (between 0 and N-1).
  * unsigned int	col		-	Column number (between 0 and N-1).
  */
 unsigned int isErroneous(Board* boardPtr, unsigned int row, unsigned int col) {
-	unsigned int i,j, count_i, count_j;
-	unsigned int m = boardPtr->m, n = boardPtr->n;
-	unsigned int N = m*n;
-	unsigned int val = getCell(boardPtr,row,col)->value;
-	Cell* cell;
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	val = getCell(boardPtr,row,col)->value;
 
 	if(val == 0) {
 		return FALSE;
 	}
-
-	/* Row */
-	for(j = 0; j < N; j++) {
-		if(j == col) continue;
-		cell = getCell(boardPtr,row,j);
-		if(cell->value == val) {
-			return TRUE;
-		}
-	}
-
-	/* Column */
-	for(i = 0; i < N; i++) {
-		if(i == row) continue;
-		cell = getCell(boardPtr,i,col);
-		if(cell->value == val) {
-			return TRUE;
-		}
-	}
-
-	/* Block */
-	i = m*((row)/m); /* Index of the first row of the block */
-	j = n*((col)/n); /* Index of the first column of the block */
-	for(count_i = 0; count_i < m; count_i++) {
-		for(count_j = 0; count_j < n; count_j++) {
-			if(i+count_i == row && j+count_j == col) continue;
-			cell = getCell(boardPtr,i+count_i,j+count_j);
-			if(cell->value == val) {
-				return TRUE;
-			}
-		}
-	}
-	return FALSE;
+	return	boardPtr->rowsCount[row*N + val-1] > 1 ||
+			boardPtr->colsCount[col*N + val-1] > 1 ||
+			boardPtr->blocksCount[getBlockIndex(boardPtr,row,col)*N + val-1] > 1;
 }
 
 
 /*
- * Given a row a column and a new value, updates the possible values for the row,
- * column, and block.
+ * Given a row a column and a new value, updates the values used by the row,
+ * column, and block of the cell, their value counts and the number of conflicts
+ * (the value of the cell itself is not changed).
  *
  * Board*	boardPtr	-	A pointer to a game board.
  * unsigned int	col		-	Column number (between 0 and N-1).
@@ -163,57 +153,29 @@ unsigned int isErroneous(Board* boardPtr, unsigned int row, unsigned int col) {
  * unsigned int	val		-	The value the user assigned to the cell. (Between 0 and N).
  */
 void updatePossibleValues(Board* boardPtr, unsigned int row, unsigned int col, unsigned int val) {
-	unsigned int	i, j, count_i, count_j;
-	unsigned int	m = boardPtr->m, n = boardPtr->n;
-	unsigned int	N = m*n;
-	unsigned int	lastVal = boardPtr->board[row][col].value;	/* remember the last value of cell */
-
-	/* Row */
-	for(j = 0; j < N; j++) {
-		if(j == col) continue;
-		if(val > 0) {
-			getCell(boardPtr,row,j)->possible_vals[val-1] = FALSE; /* set new val as invalid for the whole row. */
-
-		}
-		if(lastVal > 0) {
-			getCell(boardPtr,row,j)->possible_vals[lastVal-1] = TRUE; /* set last val as valid for the whole column. */
-		}
-
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	block = getBlockIndex(boardPtr, row, col);
+	unsigned int	lastVal = getCell(boardPtr,row,col)->value;	/* remember the last value of cell */
+
+	/* the last value is no longer used by this cell */
+	if(lastVal > 0) {
+		removeValueCount(boardPtr, &boardPtr->rowsCount[row*N + lastVal-1], &boardPtr->rowsUsed[row], lastVal);
+		removeValueCount(boardPtr, &boardPtr->colsCount[col*N + lastVal-1], &boardPtr->colsUsed[col], lastVal);
+		removeValueCount(boardPtr, &boardPtr->blocksCount[block*N + lastVal-1], &boardPtr->blocksUsed[block], lastVal);
 	}
-
-	/* Column */
-	for(i = 0; i < N; i++) {
-		if(i == row) continue;
-		if(val > 0) {
-			getCell(boardPtr,i,col)->possible_vals[val-1] = FALSE;
-		}
-		if(lastVal > 0) {
-			getCell(boardPtr,i,col)->possible_vals[lastVal-1] = TRUE;
-		}
-	}
-
-	/* Block */
-	i = m*((row)/m); /* Index of the first row of the block */
-	j = n*((col)/n); /* Index of the first column of the block */
-	for(count_i = 0; count_i < m; count_i++) {
-		for(count_j = 0; count_j < n; count_j++) {
-			if(i+count_i == row && j+count_j == col) continue;
-			if(val > 0) {
-				getCell(boardPtr,i+count_i,j+count_j)->possible_vals[val-1] = FALSE;
-			}
-			if(lastVal > 0) {
-				getCell(boardPtr,i+count_i,j+count_j)->possible_vals[lastVal-1] = TRUE;
-			}
-		}
+	/* the new value is used by the row, column and block */
+	if(val > 0) {
+		addValueCount(boardPtr, &boardPtr->rowsCount[row*N + val-1], &boardPtr->rowsUsed[row], val);
+		addValueCount(boardPtr, &boardPtr->colsCount[col*N + val-1], &boardPtr->colsUsed[col], val);
+		addValueCount(boardPtr, &boardPtr->blocksCount[block*N + val-1], &boardPtr->blocksUsed[block], val);
 	}
 }
 
 
 /*
- * 1 - updates the erroneous values of all the cells in the row, column and block
- * 2 - updates the possible values of all the cells in the row, column and block
- * 3 - Assigns the value of val to cell[row][col]->value (assuming value is possible),
- * 4 - update the number of cells displayed (used for checking if game over)
+ * 1 - updates the possible values and the value counts of the row, column and block (thus the erroneous cells)
+ * 2 - Assigns the value of val to cell[row][col]->value,
+ * 3 - update the number of cells displayed (used for checking if game over)
  *
  * Board*	boardPtr	-	A pointer to a game board.
  * unsigned int	col		-	Column number (between 0 and N-1).
@@ -222,24 +184,21 @@ void updatePossibleValues(Board* boardPtr, unsigned int row, unsigned int col, u
  */
 void setCellVal(Board* boardPtr, unsigned int row, unsigned int col, unsigned int val) {
 	unsigned int	lastVal;
-	lastVal = boardPtr->board[row][col].value;	/* remember the last value */
+	lastVal = getCell(boardPtr,row,col)->value;	/* remember the last value */
 	if(val == lastVal) { /* if you want to change the value to be the same as before - there's nothing to do */
 		return;
 	}
+	trackSolution(boardPtr, row, col, lastVal, val);
 
-	/* step 1 : update cell's possible values */
+	/* step 1 : update the values used by the cell's row, column and block (and the erroneous cells) */
 	updatePossibleValues(boardPtr, row, col, val);
 
 
 	/* step 2 : update cell's value */
 	getCell(boardPtr,row,col)->value = val;
 
-	/* step 3 : update erroneous values */
-	updateErroneous(boardPtr, row, col, lastVal);
-
 
-
-	/* step 4 :update the number of cells displayed (used for checking if game over) */
+	/* step 3 :update the number of cells displayed (used for checking if game over) */
 	if(val > 0 && lastVal == 0) {
 		boardPtr->cellsDisplayed++;
 	}
@@ -249,6 +208,143 @@ void setCellVal(Board* boardPtr, unsigned int row, unsigned int col, unsigned in
 }
 
 
+/*
+ * Assigns the value of val to cell[row][col] and updates the used values, the value counts and the number of cells displayed.
+ * Unlike setCellVal() - it assumes there are no repeated values, thus it may only be used on boards without erroneous cells
+ * (and val must be possible for the cell), such as the temporary boards of the solver.
+ * As no other cell of the row, column and block has the same value, this takes O(1) time.
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ * unsigned int	row		-	Row number (between 0 and N-1).
+ * unsigned int	col		-	Column number (between 0 and N-1).
+ * unsigned int	val		-	The value being assigned to the cell. (Between 0 and N).
+ */
+void placeCellVal(Board* boardPtr, unsigned int row, unsigned int col, unsigned int val) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	block = getBlockIndex(boardPtr, row, col);
+	Cell*			cell = getCell(boardPtr, row, col);
+
+	trackSolution(boardPtr, row, col, cell->value, val);
+	if(cell->value > 0) { /* the last value is unique in its units */
+		cand_remove(&boardPtr->rowsUsed[row], cell->value);
+		cand_remove(&boardPtr->colsUsed[col], cell->value);
+		cand_remove(&boardPtr->blocksUsed[block], cell->value);
+		boardPtr->rowsCount[row*N + cell->value-1] = 0;
+		boardPtr->colsCount[col*N + cell->value-1] = 0;
+		boardPtr->blocksCount[block*N + cell->value-1] = 0;
+		boardPtr->cellsDisplayed--;
+	}
+	if(val > 0) {
+		cand_add(&boardPtr->rowsUsed[row], val);
+		cand_add(&boardPtr->colsUsed[col], val);
+		cand_add(&boardPtr->blocksUsed[block], val);
+		boardPtr->rowsCount[row*N + val-1] = 1;
+		boardPtr->colsCount[col*N + val-1] = 1;
+		boardPtr->blocksCount[block*N + val-1] = 1;
+		boardPtr->cellsDisplayed++;
+	}
+	cell->value = val;
+}
+
+
+/*
+ * Returns the index of the block that contains cell[row][col] (between 0 and N-1, ordered left to right, top to bottom).
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ * unsigned int	row		-	Row number (between 0 and N-1).
+ * unsigned int	col		-	Column number (between 0 and N-1).
+ */
+unsigned int getBlockIndex(Board* boardPtr, unsigned int row, unsigned int col) {
+	return (row/boardPtr->m)*boardPtr->m + col/boardPtr->n;
+}
+
+
+/*
+ * ********************** PRIVATE METHOD *************************
+ * Adds an occurrence of val to a row, column or block: val becomes used by the unit,
+ * and if the unit already contains val - the number of conflicts grows.
+ *
+ * Board*			boardPtr	-	A pointer to a game board.
+ * unsigned char*	count		-	The number of cells of the unit with value val.
+ * Candidates*		used		-	The values used by the unit.
+ * unsigned int		val			-	The value that is added to the unit. (Between 1 and N).
+ */
+void addValueCount(Board* boardPtr, unsigned char* count, Candidates* used, unsigned int val) {
+	if(*count == 0) {
+		cand_add(used, val);
+	}
+	else { /* val is repeated in the unit */
+		boardPtr->conflicts++;
+	}
+	(*count)++;
+}
+
+
+/*
+ * ********************** PRIVATE METHOD *************************
+ * Removes an occurrence of val from a row, column or block: val is no longer used by the unit
+ * unless another cell of the unit contains it too (ie. an erroneous value), in which case the number of conflicts drops.
+ *
+ * Board*			boardPtr	-	A pointer to a game board.
+ * unsigned char*	count		-	The number of cells of the unit with value val.
+ * Candidates*		used		-	The values used by the unit.
+ * unsigned int		val			-	The value that is removed from the unit. (Between 1 and N).
+ */
+void removeValueCount(Board* boardPtr, unsigned char* count, Candidates* used, unsigned int val) {
+	(*count)--;
+	if(*count == 0) {
+		cand_remove(used, val);
+	}
+	else { /* val was repeated in the unit */
+		boardPtr->conflicts--;
+	}
+}
+
+
+/*
+ * ********************** PRIVATE METHOD *************************
+ * Returns the size (in bytes) of the single allocation holding the cells, the used values and the value counts of an NxN board:
+ * rowsUsed, colsUsed and blocksUsed (N sets each), the N*N cells, row by row,
+ * and rowsCount, colsCount and blocksCount (N*N counts each).
+ * The parts are ordered by decreasing alignment, so all of them are properly aligned.
+ *
+ * unsigned int	N		-	The number of rows (and columns) of the board.
+ */
+size_t boardSize(unsigned int N) {
+	return 3 * N * sizeof(Candidates) + N * N * sizeof(Cell) + 3 * N * N * sizeof(unsigned char);
+}
+
+
+/*
+ * ********************** PRIVATE METHOD *************************
+ * Updates the state of the solution cache (see isSolutionCurrent()) after cell[row][col] of a board changed:
+ * a change of gameBoard updates the number of cells whose value differs from their solution value,
+ * and any change of solutionBoard makes it a different solution (it must be marked again).
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ * unsigned int	row		-	Row number (between 0 and N-1).
+ * unsigned int	col		-	Column number (between 0 and N-1).
+ * unsigned int	lastVal	-	The last value of the cell (Between 0 and N).
+ * unsigned int	val		-	The new value of the cell (Between 0 and N).
+ */
+void trackSolution(Board* boardPtr, unsigned int row, unsigned int col, unsigned int lastVal, unsigned int val) {
+	unsigned int	solVal;
+	if(boardPtr == &solutionBoard) {
+		solutionCached = FALSE;
+	}
+	if(boardPtr != &gameBoard || !solutionCached) {
+		return;
+	}
+	solVal = getCell(&solutionBoard, row, col)->value;
+	if(lastVal != 0 && lastVal != solVal) { /* a mismatch is cleared or replaced */
+		solutionMismatches--;
+	}
+	if(val != 0 && val != solVal) { /* a new mismatch */
+		solutionMismatches++;
+	}
+}
+
+
 /* --------------- Board functions --------------- */
 
 
@@ -259,22 +355,8 @@ void setCellVal(Board* boardPtr, unsigned int row, unsigned int col, unsigned in
  * pre: boardPtr != NULL
  */
 void freeBoard(Board* boardPtr) {
-	unsigned int i, j;
-	unsigned int N;
-	Cell* temp_cell;
-
-	N = boardPtr->m*boardPtr->n;
-	/* free allocated possible_vals for each cell, and free rows */
-	for(i = 0; i < N; i++) {
-		for(j = 0; j < N; j++) {
-			temp_cell = getCell(boardPtr,i,j);
-			free(temp_cell->possible_vals);
-		}
-		/* free allocated row */
-		free(boardPtr->board[i]);
-	}
-	/* free the board itself */
-	free(boardPtr->board);
+	/* the used values, the cells and the value counts share one allocation (see initializeBoard()) */
+	free(boardPtr->rowsUsed);
 }
 
 
@@ -287,19 +369,13 @@ void freeBoard(Board* boardPtr) {
  *
  */
 void nullifyBoard(Board* boardPtr) {
-	unsigned int	N = boardPtr->m * boardPtr->n;
-	unsigned int	i,j,k;
-	for(i = 0; i < N; i++) {
-		for(j = 0; j < N; j++) {
-			boardPtr->board[i][j].value = 0;
-			boardPtr->board[i][j].fixed = FALSE;
-			boardPtr->board[i][j].isErroneous = FALSE;
-			for(k = 0; k < N; k++) {
-				boardPtr->board[i][j].possible_vals[k] = TRUE;
-			}
-		}
-	}
+	/* all the cells, used values and value counts are zero bits (value 0, not fixed, empty sets, no occurrences) */
+	memset(boardPtr->rowsUsed, 0, boardSize(boardPtr->m * boardPtr->n));
 	boardPtr->cellsDisplayed = 0;
+	boardPtr->conflicts = 0;
+	if(boardPtr == &gameBoard || boardPtr == &solutionBoard) { /* a new game (or solution) */
+		solutionCached = FALSE;
+	}
 }
 
 
@@ -312,7 +388,6 @@ void nullifyBoard(Board* boardPtr) {
  *
  */
 void initializeBoard(Board* boardPtr, unsigned int m, unsigned int n) {
-	unsigned int i, j;
 	unsigned int N = m*n;
 
 	/* if possible, do not allocate memory again but only nullify the already initialized board */
@@ -324,26 +399,18 @@ void initializeBoard(Board* boardPtr, unsigned int m, unsigned int n) {
 	boardPtr->m = m;
 	boardPtr->n = n;
 
-	/* Allocate space */
-    boardPtr->board = (Cell**)malloc(N * sizeof(Cell*)); 												/* rows */
-	if(boardPtr->board == NULL) {
+	/* Allocate space - a single block: rowsUsed, colsUsed, blocksUsed (N each), the N*N cells and the counts (N*N each) */
+    boardPtr->rowsUsed = (Candidates*)malloc(boardSize(N));
+	if(boardPtr->rowsUsed == NULL) {
 		printf("Error: malloc has failed\n");
 		exit(1);
 	}
-    for (i = 0; i < N; i++) {
-    	boardPtr->board[i] = (Cell*)malloc(N * sizeof(Cell));	 										/* Cells */
-     	if(boardPtr->board[i] == NULL) {
-     		printf("Error: malloc has failed\n");
-     		exit(1);
-     	}
-         for(j = 0; j < N; j++) {
-        	 boardPtr->board[i][j].possible_vals = (unsigned int*)malloc((N+1) * sizeof(unsigned int));	/* Possible values */
-        		if(boardPtr->board[i][j].possible_vals == NULL) {
-        			printf("Error: malloc has failed\n");
-        			exit(1);
-        		}
-         }
-    }
+	boardPtr->colsUsed = boardPtr->rowsUsed + N;
+	boardPtr->blocksUsed = boardPtr->colsUsed + N;
+	boardPtr->cells = (Cell*)(boardPtr->blocksUsed + N);
+	boardPtr->rowsCount = (unsigned char*)(boardPtr->cells + N*N);
+	boardPtr->colsCount = boardPtr->rowsCount + N*N;
+	boardPtr->blocksCount = boardPtr->colsCount + N*N;
 
     /* set empty values */
     nullifyBoard(boardPtr);
@@ -370,23 +437,15 @@ unsigned int isBoardEmpty(Board board){
  */
 void copyBoard(Board* original, Board* copy) {
 	unsigned int	m = original->m, n = original->n;
-	unsigned int	N = m*n;
-	unsigned int i, j, k;
-	Cell* copyCell;
-	for(i = 0; i < N; i++) {
-		for(j = 0; j < N; j++) {
-			copyCell = getCell(copy,i,j);
-			copyCell->fixed = getCell(original,i,j)->fixed;
-			copyCell->value = getCell(original,i,j)->value;
-			for(k = 0; k < N; k++) {
-				getCell(copy,i,j)->possible_vals[k] = getCell(original,i,j)->possible_vals[k];
-			}
-		}
-
-	}
+	/* the cells, the used values and the value counts are stored in one block (see initializeBoard()) */
+	memcpy(copy->rowsUsed, original->rowsUsed, boardSize(m*n));
 	copy->m = m;
 	copy->n = n;
 	copy->cellsDisplayed = original->cellsDisplayed;
+	copy->conflicts = original->conflicts;
+	if(copy == &gameBoard || copy == &solutionBoard) {
+		solutionCached = FALSE;
+	}
 }
 
 
@@ -407,22 +466,12 @@ Board* getSolutionBoardPtr() {
 
 
 /*
- * Checks if boardPtr->board has any erroneous cells.
+ * Checks if boardPtr->board has any erroneous cells (ie. any repeated values).
  *
  * Board*	boardPtr	-	A pointer to a game board.
  */
 unsigned int hasErrors(Board* boardPtr) {
-	unsigned int N = boardPtr->m*boardPtr->n;
-	unsigned int row, col;
-	for(row = 0; row < N; row++) {
-		for(col=0; col < N; col++) {
-			if(getCell(boardPtr,row,col)->isErroneous) { /* found erroneous cell */
-				return TRUE;
-			}
-		}
-	}
-	/* no erroneous cells found */
-	return FALSE;
+	return boardPtr->conflicts > 0;
 }
 
 
@@ -446,67 +495,6 @@ void initializeGame(Board* gBoard, Board* sBoard, unsigned int m, unsigned int n
 }
 
 
-/*
- * Updates all cells that may have changed from erroneous to not erroneous or the other way around,
- * given that cell[row][col] of boardPtr->board has changed its value.
- *
- * Board*	boardPtr	-	A pointer to a game board.
- * unsigned int	row		-	Row number (between 0 and N-1).
- * unsigned int	col		-	Column number (between 0 and N-1).
- * unsigned int	lastVal	-	The previous value of cell[row][col] of boardPtr->board (before its value has changed)
- */
-void updateErroneous(Board* boardPtr, unsigned int row, unsigned int col, unsigned int lastVal) {
-	unsigned int	i,j, count_i, count_j;
-	unsigned int	m = boardPtr->m, n = boardPtr->n;
-	unsigned int	N = m*n;
-	unsigned int	newVal = getCell(boardPtr,row,col)->value; /* the new value of cell[row][col] */
-	Cell*			cell;
-
-	cell = getCell(boardPtr,row,col);
-	cell->isErroneous = isErroneous(boardPtr,row,col); /* First update the changed cell */
-
-	/* Row */
-	for(j = 0; j < N; j++) {
-		if(j == col) continue; /* no need to re-check the changed cell */
-		cell = getCell(boardPtr,row,j);
-		if(newVal != 0 && cell->value == newVal) { /* another cell in the row with the same non-zero value */
-			cell->isErroneous = TRUE;
-		}
-		else if(cell->value == lastVal) { /* Might have been erroneous but now isn't. check if erroneous. */
-			cell->isErroneous = isErroneous(boardPtr,row,j);
-		}
-	}
-
-	/* Column */
-	for(i = 0; i < N; i++) {
-		if(i == row) continue; /* no need to re-check the changed cell */
-		cell = getCell(boardPtr,i,col);
-		if(newVal != 0 && cell->value == newVal) { /* another cell in the column with the same non-zero value */
-			cell->isErroneous = TRUE;
-		}
-		else if(cell->value == lastVal) { /* Might have been erroneous but now isn't. check if erroneous. */
-			cell->isErroneous = isErroneous(boardPtr,i,col);
-		}
-	}
-
-	/* Block */
-	i = m*((row)/m); /* Index of the first row of the block */
-	j = n*((col)/n); /* Index of the first column of the block */
-	for(count_i = 0; count_i < m; count_i++) {
-		for(count_j = 0; count_j < n; count_j++) {
-			if(i+count_i == row || j+count_j == col) continue; /* no need to re-check cells from the same row or column as they were already checked previously */
-			cell = getCell(boardPtr, i+count_i, j+count_j);
-			if(newVal != 0 && cell->value == newVal) { /* another cell in the block with the same non-zero value */
-				cell->isErroneous = TRUE;
-			}
-			else if(cell->value == lastVal) {
-				cell->isErroneous = isErroneous(boardPtr, i+count_i, j+count_j);
-			}
-		}
-	}
-}
-
-
 /*
  * Sets the value of gameMode to newGameMode.
  *
@@ -543,6 +531,28 @@ unsigned int getMarkErrors() {
 }
 
 
+/*
+ * Returns TRUE iff solutionBoard holds a solution of gameBoard - ie. it was marked by setSolutionCurrent(),
+ * and no cell of gameBoard was set to a value other than its value in solutionBoard since
+ * (clearing a cell, or setting it to its solution value, keeps the solution).
+ * The solution of a board is cached this way, so the hint and validate commands don't solve it again.
+ */
+unsigned int isSolutionCurrent() {
+	return solutionCached && solutionMismatches == 0;
+}
+
+
+/*
+ * Marks solutionBoard as a solution of gameBoard (see isSolutionCurrent()).
+ *
+ * pre: solutionBoard holds a solution of gameBoard
+ */
+void setSolutionCurrent() {
+	solutionCached = TRUE;
+	solutionMismatches = 0;
+}
+
+
 /* --------------- Move-list functions --------------- */
 
 
@@ -12,10 +12,12 @@
  * 	2. getHint()				:	Given a column and row of a cell - returns the solution value of the cell
  * 	3. isCellFixed()			:	Given a column and row of a cell - return TRUE iff cell is fixed
  *     								in boardPtr->board.
- * 	4. isErroneous()			:	Checks if cell[row][col] of boardPtr->board contains an erroneous value.
- * 	5. updatePossibleValues ()	:	Given a row a column and a new value, updates the possible values for the row
+ * 	4. isErroneous()			:	Checks if cell[row][col] of boardPtr->board contains an erroneous value (in O(1) time).
+ * 	5. updatePossibleValues ()	:	Given a row a column and a new value, updates the values used by the row
  *     								column, and block.
  * 	6. setCellVal ()			:	Assigns value to a cell, and update other variables as necessary.
+ * 	7. placeCellVal ()			:	Assigns value to a cell of a board without erroneous cells, updating only the used values.
+ * 	8. getBlockIndex ()			:	Returns the index of the block that contains a cell.
  *
  *
  * B. Board functions:
@@ -27,17 +29,18 @@
  * 	5. copyBoard()				:	Copies the contents of the original board to the copied board.
  * 	6. getGameBoardPtr()		:	Returns a pointer to gameBoard
  * 	7. getSolutionBoardPtr()	:	Returns a pointer to solutionBoard.
- *  8. hasErrors()				:	Checks if boardPtr->board has any erroneous cells.
+ *  8. hasErrors()				:	Checks if boardPtr->board has any erroneous cells (in O(1) time).
  *
  *
  * C. Game functions:
  * 	1. initializeGame()			:	Initializes a new empty game board and a solution board,
  * 	   								frees previously allocated space used by these boards.
- * 	2. updateErroneous()		:	Updates all cells that may have changed from erroneous to not erroneous or the other way around.
- *  3. setGameMode()			:	Sets the value of gameMode to a new Game Mode.
- *  4. getGameMode()			:	Returns the value of gameMode.
- *  5. setMarkErrors()			:	Sets the value of markErrors to mark (assumes mark is 0 or 1).
- *  6. getMarkErrors()			:	Returns the value of markErrors.
+ *  2. setGameMode()			:	Sets the value of gameMode to a new Game Mode.
+ *  3. getGameMode()			:	Returns the value of gameMode.
+ *  4. setMarkErrors()			:	Sets the value of markErrors to mark (assumes mark is 0 or 1).
+ *  5. getMarkErrors()			:	Returns the value of markErrors.
+ *  6. isSolutionCurrent()		:	Returns TRUE iff solutionBoard holds a solution of gameBoard.
+ *  7. setSolutionCurrent()		:	Marks solutionBoard as a solution of gameBoard.
  *
  *
  * D. Move-list functions:
@@ -50,6 +53,7 @@
  */
 
 #include "LinkedList.h"
+#include "Candidates.h"
 
 #define	FALSE		0
 #define	TRUE		1
@@ -68,22 +72,30 @@
 typedef struct cell_t {
 	unsigned int	value;				/* Cell value*/
 	unsigned int	fixed;				/* TRUE or FALSE */
-	unsigned int	isErroneous;		/* an indicator to "is the value of this cell erroneous?". */
-	unsigned int*	possible_vals;		/* the possible values for this cell.
-									 	 * ie. value val is possible iff:
-									 	 * possible_vals[val-1] = 1
-									 	 */
 } Cell;
 #endif
 
 
 /*
  * Board structure.
+ * The possible values of an empty cell are all values that are not used by its row, column or block, ie.
+ * value val is possible for cell[row][col] iff val is in none of:
+ * rowsUsed[row], colsUsed[col], blocksUsed[getBlockIndex(boardPtr,row,col)]
+ *
+ * The board also counts the occurrences of each value in each row, column and block, so a cell is erroneous iff
+ * one of its units contains its value more than once, and the board has erroneous cells iff conflicts > 0.
  */
 #ifndef BOARD_H
 #define BOARD_H
 typedef struct board_t {
-	Cell**			board;						/* A two-dimentional array of cells */
+	Cell*			cells;						/* cells[row*N+col] - the cells, row by row (see initializeBoard()) */
+	Candidates*		rowsUsed;					/* rowsUsed[i] - the values of the cells of row i (size: N) */
+	Candidates*		colsUsed;					/* colsUsed[j] - the values of the cells of column j (size: N) */
+	Candidates*		blocksUsed;					/* blocksUsed[b] - the values of the cells of block b (size: N) */
+	unsigned char*	rowsCount;					/* rowsCount[i*N + val-1] - the number of cells of row i with value val (size: N*N) */
+	unsigned char*	colsCount;					/* colsCount[j*N + val-1] - the number of cells of column j with value val (size: N*N) */
+	unsigned char*	blocksCount;				/* blocksCount[b*N + val-1] - the number of cells of block b with value val (size: N*N) */
+	unsigned int	conflicts;					/* the number of repeated values in all rows, columns and blocks (0 iff no erroneous cells) */
 	unsigned int	cellsDisplayed;				/* Number of cells with a value greater than zero */
 	unsigned int	m;							/* number of rows in each block on the board.*/
 	unsigned int	n;							/* number of columns in each block on the board. */
@@ -124,7 +136,8 @@ unsigned int	isCellFixed(Board*, unsigned int, unsigned int);
 
 
 /*
- * Checks if cell[row][col] of boardPtr->board contains an erroneous value.
+ * Checks if cell[row][col] of boardPtr->board contains an erroneous value,
+ * ie. if its row, column or block contains its value more than once.
  *
  * Board*	boardPtr	-	A pointer to a game board.
  * unsigned int	row		-	Row number (between 0 and N-1).
@@ -134,8 +147,9 @@ unsigned int	isErroneous(Board*, unsigned int, unsigned int);
 
 
 /*
- * Given a row a column and a new value, updates the possible values for the row,
- * column, and block in boardPtr->board. Also marks as erroneous if necessary.
+ * Given a row a column and a new value, updates the values used by the row,
+ * column, and block of the cell, their value counts and the number of conflicts
+ * (the value of the cell itself is not changed).
  *
  * Board*	boardPtr	-	A pointer to a game board.
  * unsigned int	row		-	Row number (between 0 and N-1).
@@ -145,10 +159,9 @@ unsigned int	isErroneous(Board*, unsigned int, unsigned int);
 void			updatePossibleValues(Board*, unsigned int, unsigned int, unsigned int);
 
 /*
- * 1 - updates the erroneous values of all the cells in the row, column and block
- * 2 - updates the possible values of all the cells in the row, column and block
- * 3 - Assigns the value of val to cell[row][col]->value (assuming value is possible),
- * 4 - update the number of cells displayed (used for checking if game over)
+ * 1 - updates the possible values and the value counts of the row, column and block (thus the erroneous cells)
+ * 2 - Assigns the value of val to cell[row][col]->value,
+ * 3 - update the number of cells displayed (used for checking if game over)
  *
  * Board*	boardPtr	-	A pointer to a game board.
  * unsigned int	col		-	Column number (between 0 and N-1).
@@ -158,6 +171,29 @@ void			updatePossibleValues(Board*, unsigned int, unsigned int, unsigned int);
 void			setCellVal(Board*, unsigned int, unsigned int, unsigned int);
 
 
+/*
+ * Assigns the value of val to cell[row][col] and updates the used values, the value counts and the number of cells displayed.
+ * Unlike setCellVal() - it assumes there are no repeated values, thus it may only be used on boards without erroneous cells
+ * (and val must be possible for the cell), such as the temporary boards of the solver.
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ * unsigned int	row		-	Row number (between 0 and N-1).
+ * unsigned int	col		-	Column number (between 0 and N-1).
+ * unsigned int	val		-	The value being assigned to the cell. (Between 0 and N).
+ */
+void			placeCellVal(Board*, unsigned int, unsigned int, unsigned int);
+
+
+/*
+ * Returns the index of the block that contains cell[row][col] (between 0 and N-1, ordered left to right, top to bottom).
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ * unsigned int	row		-	Row number (between 0 and N-1).
+ * unsigned int	col		-	Column number (between 0 and N-1).
+ */
+unsigned int	getBlockIndex(Board*, unsigned int, unsigned int);
+
+
 /* --------------- Board functions --------------- */
 
 /*
@@ -220,7 +256,7 @@ Board*			getGameBoardPtr();
 Board*			getSolutionBoardPtr();
 
 /*
- * Checks if boardPtr->board has any erroneous cells.
+ * Checks if boardPtr->board has any erroneous cells (ie. any repeated values).
  *
  * Board*	boardPtr	-	A pointer to a game board.
  */
@@ -240,17 +276,6 @@ unsigned int	hasErrors(Board*);
  */
 void 			initializeGame(Board*, Board*, unsigned int, unsigned int);
 
-/*
- * Updates all cells that may have changed from erroneous to not erroneous or the other way around,
- * given that cell[row][col] of boardPtr->board has changed its value.
- *
- * Board*	boardPtr	-	A pointer to a game board.
- * unsigned int	col		-	Column number (between 0 and N-1).
- * unsigned int	row		-	Row number (between 0 and N-1).
- * unsigned int	lastVal	-	The previous value of cell[row][col] of boardPtr->board (before its value has changed)
- */
-void 			updateErroneous(Board*, unsigned int, unsigned int, unsigned int);
-
 /*
  * Sets the value of gameMode to newGameMode.
  *
@@ -275,6 +300,21 @@ void			setMarkErrors(unsigned int);
  */
 unsigned int	getMarkErrors();
 
+/*
+ * Returns TRUE iff solutionBoard holds a solution of gameBoard - ie. it was marked by setSolutionCurrent(),
+ * and no cell of gameBoard was set to a value other than its value in solutionBoard since
+ * (clearing a cell, or setting it to its solution value, keeps the solution).
+ * The solution of a board is cached this way, so the hint and validate commands don't solve it again.
+ */
+unsigned int	isSolutionCurrent();
+
+/*
+ * Marks solutionBoard as a solution of gameBoard (see isSolutionCurrent()).
+ *
+ * pre: solutionBoard holds a solution of gameBoard
+ */
+void			setSolutionCurrent();
+
 
 /* --------------- Move-list functions --------------- */
 
@@ -3,32 +3,140 @@
  * It is being used in order to solve puzzles and check possible solutions to them,
  * much more efficiently than the brute-force backtracking method used in exercise 3.
  *
- * The module includes one public function:
+ * The module includes four public functions:
  * 	ilpSolve()					:	Solve a game board and update its solution board,
  *  			 					using Integer Linear Programming (ILP) with the Gurobi library.
- *  			 					return TRUE iff board is solvable.
+ *  			 					return TRUE iff board is solvable (-1 on Gurobi failure).
+ * 	ilpSolveGame()				:	Solve the board of the game and update its solution board,
+ * 								with a model that is kept (and updated) between the calls.
+ * 	ilpFreeEnv()				:	Frees the Gurobi environment of the calling thread.
+ * 	ilpAvailable()				:	Returns TRUE iff the program was built with the Gurobi library.
  *
- *  This public function uses five private functions:
+ *  Loading a Gurobi environment (and checking the license) takes much longer than solving a small board,
+ *  so each thread loads its environment once - on its first call to ilpSolve() - and reuses it for all of its models.
+ *  The environments of the worker threads are freed when they exit, the one of the main thread by ilpFreeEnv().
+ *  Gurobi doesn't write a log file, unless the SUDOKU_ILP_LOG environment variable names one.
+ *
+ *  When built with NO_GUROBI defined (without the Gurobi library), ilpSolve() always reports a Gurobi failure.
+ *
+ *  These public functions use fourteen private functions:
  * 	1 - getIndex()				:	Return the index of cell with row r, column c and value v, in a one-dimensional array.
- * 	2 - createGurobiEnvModel()	:	Creates a Gurobi environment and an empty model.
- * 	3 - initObjectiveFunction()	:	Initializes the objective function.
- * 	4 - addConstraints()		:	Adds all of the constraints needed for the model.
- * 	5 - updateSolution()		:	Updates the solution board according to the optimized solution to the model.
+ * 	2 - createGurobiEnvModel()	:	Gets the Gurobi environment of the thread and creates an empty model.
+ * 	3 - mapVariables()			:	Maps the legal values of the empty cells to the variables of the model.
+ * 	4 - initObjectiveFunction()	:	Initializes the objective function.
+ * 	5 - addConstraints()		:	Adds the constraints of the model that the filled cells don't satisfy yet.
+ * 	6 - addTerm()				:	Adds a variable to the last constraint of a type.
+ * 	7 - submitConstraints()		:	Adds the constraints of a type to the model, with a single call to Gurobi.
+ * 	8 - updateSolution()		:	Updates the solution board according to the optimized solution to the model.
+ * 	9 - getGurobiEnv()			:	Returns the Gurobi environment of the calling thread, and loads it on the first call.
+ * 	10 - createEnvKey()			:	Creates the key of the environments of the threads (once).
+ * 	11 - freeThreadEnv()		:	Frees the Gurobi environment of a thread that exits.
+ * 	12 - createGameModel()		:	Builds the model of the game for a geometry.
+ * 	13 - freeGameModel()		:	Frees the model of the game.
+ * 	14 - updateBounds()			:	Sets the bounds of the variables of the model of the game to a board.
  */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include "Game.h"
+#include "ILP_Solver.h"
+
+#ifdef NO_GUROBI
+
+/*
+ *  Reports a Gurobi failure - the program was built without the Gurobi library.
+ *
+ *  Board*	boardPtr	-	A pointer a game board (unused).
+ *  Board*	solBoardPtr	-	A pointer to the solution board (unused).
+ */
+int ilpSolve(Board* boardPtr, Board* solBoardPtr) {
+	(void)boardPtr;
+	(void)solBoardPtr;
+	printf("Error: the program was built without Gurobi\n");
+	return -1;
+}
+
+
+/*
+ *  Reports a Gurobi failure - the program was built without the Gurobi library.
+ *
+ *  Board*	boardPtr	-	A pointer a game board (unused).
+ *  Board*	solBoardPtr	-	A pointer to the solution board (unused).
+ */
+int ilpSolveGame(Board* boardPtr, Board* solBoardPtr) {
+	return ilpSolve(boardPtr, solBoardPtr);
+}
+
+
+/*
+ *  Does nothing - there is no Gurobi environment.
+ */
+void ilpFreeEnv() {
+}
+
+
+/*
+ *  Returns FALSE - the program was built without the Gurobi library.
+ */
+unsigned int ilpAvailable() {
+	return FALSE;
+}
+
+#else /* NO_GUROBI */
+
+#include <pthread.h>
 #include "gurobi_c.h"
 
+#define ILP_LOG_ENV_VARIABLE	"SUDOKU_ILP_LOG"	/* names the Gurobi log file (no log file if not set) */
+
+pthread_once_t	ilpEnvOnce = PTHREAD_ONCE_INIT;
+pthread_key_t	ilpEnvKey;		/* the Gurobi environment of each thread (NULL until its first ilpSolve()) */
+
+/*
+ * The constraints of one type, in compressed sparse row (CSR) form - the form of GRBaddconstrs().
+ * The variables of the k'th constraint are cind[cbeg[k]] to cind[cbeg[k+1]-1] (to cind[numNz-1] for the last one).
+ */
+typedef struct constraints_t {
+	int			numConstrs;		/* number of constraints */
+	int			numNz;			/* number of variables in all of the constraints */
+	int*		cbeg;			/* cbeg[k] - the position of the first variable of the k'th constraint in cind */
+	int*		cind;			/* the variables of the constraints, constraint after constraint */
+	double*		cval;			/* the coefficients of the variables (all 1) */
+	char*		sense;			/* the sense of each constraint (all GRB_EQUAL) */
+	double*		rhs;			/* the right-hand side of each constraint (all 1) */
+} Constraints;
+
+/*
+ * The model of the game (see ilpSolveGame()) - kept between the calls of the main thread.
+ */
+typedef struct game_model_t {
+	GRBmodel*		model;		/* NULL if there is no model yet */
+	unsigned int	m, n;		/* the geometry of the boards of the model */
+	int*			varIndex;	/* the variable of each cell and value - the model has all of them (size: N^3) */
+	double*			lb;			/* the current lower bounds of the variables (size: N^3) */
+	double*			ub;			/* the current upper bounds of the variables (size: N^3) */
+	double*			start;		/* the last solution found - the MIP start of the next call (size: N^3) */
+	unsigned int	hasStart;	/* TRUE iff start holds a solution */
+} GameModel;
+
+GameModel	gameModel = {NULL, 0, 0, NULL, NULL, NULL, NULL, FALSE};
 
 /********** Private method declarations **********/
 
 unsigned int	getIndex(unsigned int, unsigned int, unsigned int, unsigned int);
 unsigned int	createGurobiEnvModel(GRBenv**, GRBmodel**);
+unsigned int	mapVariables(Board*, int*);
 unsigned int	initObjectiveFunction(GRBenv*, GRBmodel**, unsigned int, char*);
-unsigned int	addConstraints(GRBenv*, GRBmodel*, Board*, unsigned int, unsigned int);
-void			updateSolution(Board*, double*, unsigned int);
+unsigned int	addConstraints(GRBenv*, GRBmodel*, Board*, int*, unsigned int);
+void			addTerm(Constraints*, int);
+unsigned int	submitConstraints(GRBenv*, GRBmodel*, Constraints*);
+void			updateSolution(Board*, Board*, double*, int*);
+unsigned int	getGurobiEnv(GRBenv**);
+void			createEnvKey();
+void			freeThreadEnv(void*);
+unsigned int	createGameModel(GRBenv*, unsigned int, unsigned int);
+void			freeGameModel();
+unsigned int	updateBounds(GRBenv*, Board*);
 
 /******* End of private method declarations ******/
 
@@ -39,7 +147,10 @@ void			updateSolution(Board*, double*, unsigned int);
 /*
  *  Solve a game board and update its solution board,
  *  using Integer Linear Programming (ILP) with the Gurobi library.
- *  return TRUE iff board is solvable.
+ *  return TRUE iff board is solvable (-1 on Gurobi failure).
+ *
+ *  The model only has variables for the legal values of the empty cells (see mapVariables()),
+ *  so the fuller the board - the smaller the model.
  *
  *  Board*	boardPtr	-	A pointer a game board.
  *  Board*	solBoardPtr	-	A pointer to the solution board. used to update the solution board.
@@ -50,26 +161,41 @@ int ilpSolve(Board* boardPtr, Board* solBoardPtr) {
 	GRBmodel		*model = NULL;
 	int				error = 0;
 	int				optimstatus;		/* TRUE iff model is feasible */
-	char*			vtype;				/* variable types (binary) (size: N^3).*/
-	double*			sol;				/* stores the solution values of the model (size: N^3).*/
+	int*			varIndex;			/* the variable of each cell and value, or -1 (size: N^3, see mapVariables()).*/
+	unsigned int	numVars;			/* number of variables of the model. */
+	char*			vtype;				/* variable types (binary) (size: numVars).*/
+	double*			sol;				/* stores the solution values of the model (size: numVars).*/
 
 	/* some helpful variables */
 	unsigned int	m = boardPtr->m;
 	unsigned int	n = boardPtr->n;
 	unsigned int	N = m*n;
 	unsigned int	N3 = N*N*N;
-	unsigned int	ret = TRUE;				/* return value */
+	int				ret = TRUE;				/* return value */
+
+	/* the model has no constraints between the filled cells - a board with erroneous values is not solvable */
+	if(hasErrors(boardPtr)) {
+		return FALSE;
+	}
+
+	/* Map the variables */
+	varIndex = (int*)malloc(N3*sizeof(int));
+	if(varIndex == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	numVars = mapVariables(boardPtr, varIndex);
 
 	/* Add variables */
-	/* variable types (binary). */
-	vtype = (char*)malloc(N3*sizeof(char));
+	/* variable types (binary). (one more, so a full board doesn't allocate 0 bytes) */
+	vtype = (char*)malloc((numVars+1)*sizeof(char));
 	if(vtype == NULL) {
 		printf("Error: malloc has failed\n");
 		exit(1);
 	}
 
 
-	sol = (double*)calloc(N*N*N ,sizeof(double));
+	sol = (double*)calloc(numVars+1 ,sizeof(double));
 	if(sol == NULL) {
 		printf("Error: calloc has failed\n");
 		exit(1);
@@ -82,23 +208,23 @@ int ilpSolve(Board* boardPtr, Board* solBoardPtr) {
 		ret = -1;
 	}
 	/*------------------- step2: Objective function ------------------*/
-	if(ret) { /* no errors */
-		error = initObjectiveFunction(env,&model,N,vtype);
+	if(ret == TRUE) { /* no errors */
+		error = initObjectiveFunction(env,&model,numVars,vtype);
 		if(error) {
 			ret = -1;
 		}
 	}
 
 	/* ------------------- step3: Add constraints ------------------- */
-	if(ret) { /* no errors */
-		error = addConstraints(env,model,boardPtr,m,n);
+	if(ret == TRUE) { /* no errors */
+		error = addConstraints(env,model,boardPtr,varIndex,numVars);
 		if(error) {
 			ret = -1;
 		}
 	}
 	/* ---------------------- step4: Optimize ----------------------- */
 	/* Optimize model - need to call this before calculation */
-	if(ret) { /* no errors */
+	if(ret == TRUE) { /* no errors */
 		error = GRBoptimize(model);
 		if (error) {
 			printf("ERROR %d GRBoptimize(): %s\n", error, GRBgeterrormsg(env));
@@ -106,7 +232,7 @@ int ilpSolve(Board* boardPtr, Board* solBoardPtr) {
 		}
 	}
 	/* --------- step5: Get optimization status (feasible/not feasible) ------------------ */
-	if(ret) { /* no errors */
+	if(ret == TRUE) { /* no errors */
 		error = GRBgetintattr(model, GRB_INT_ATTR_STATUS, &optimstatus);
 		if (error) {
 			printf("ERROR %d GRBgetintattr(): %s\n", error, GRBgeterrormsg(env));
@@ -114,17 +240,17 @@ int ilpSolve(Board* boardPtr, Board* solBoardPtr) {
 		}
 	}
 	/* --------- step6: get the solution - the assignment to each variable --------------- */
-	if(ret) { /* no errors */
+	if(ret == TRUE) { /* no errors */
 		if(optimstatus == GRB_OPTIMAL) { /* Model is feasible. Solution found. */
 			/* fetch the solution (saved in sol) */
-			error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, N3, sol);
+			error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, numVars, sol);
 			if (error) {
 				printf("ERROR %d GRBgetdblattrarray(): %s\n", error, GRBgeterrormsg(env));
 				ret = -1;
 			}
 			else {
 				ret = TRUE; /* solution found */
-				updateSolution(solBoardPtr,sol,N); /* Update solution board to the values assigned by the optimized model */
+				updateSolution(boardPtr,solBoardPtr,sol,varIndex); /* Update solution board to the values assigned by the optimized model */
 			}
 		}
 		else { /* Model is infeasible. No solution found. */
@@ -132,16 +258,125 @@ int ilpSolve(Board* boardPtr, Board* solBoardPtr) {
 		}
 	}
 
-	/* Free model and environment */
+	/* Free model (the environment is kept for the next call) */
 	GRBfreemodel(model);
-	GRBfreeenv(env);
 	/* Free arrays */
 	free(sol);
 	free(vtype);
+	free(varIndex);
 
 	return ret;
 }
 
+/*
+ *  Solve the board of the game and update its solution board, like ilpSolve() - but with the model of the game,
+ *  which is kept between the calls: it is built once for the geometry of the board, with a variable for every
+ *  cell and value, and each call only changes the bounds of the variables that changed since the last call
+ *  (the values set, cleared and made illegal by the moves). The last solution found is the MIP start of the next call.
+ *  return TRUE iff board is solvable (-1 on Gurobi failure).
+ *
+ *  Used by the main thread only (the model is not shared with the worker threads).
+ *
+ *  Board*	boardPtr	-	A pointer a game board.
+ *  Board*	solBoardPtr	-	A pointer to the solution board. used to update the solution board.
+ */
+int ilpSolveGame(Board* boardPtr, Board* solBoardPtr) {
+	GRBenv			*env   = NULL;
+	int				error = 0;
+	int				optimstatus;		/* TRUE iff model is feasible */
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	N3 = N*N*N;
+	int				ret = TRUE;			/* return value */
+
+	/* the model has no constraints between the filled cells - a board with erroneous values is not solvable */
+	if(hasErrors(boardPtr)) {
+		return FALSE;
+	}
+
+	/* --------- step1: Get the model of the game (built again if the geometry changed) ---------- */
+	if(gameModel.model != NULL && (gameModel.m != boardPtr->m || gameModel.n != boardPtr->n)) {
+		freeGameModel();
+	}
+	if(getGurobiEnv(&env) || (gameModel.model == NULL && createGameModel(env, boardPtr->m, boardPtr->n))) {
+		ret = -1;
+	}
+	/* ------------- step2: Update the bounds, and start from the last solution -------------- */
+	if(ret == TRUE) {
+		error = updateBounds(env, boardPtr);
+		if(!error && gameModel.hasStart) {
+			error = GRBsetdblattrarray(gameModel.model, GRB_DBL_ATTR_START, 0, N3, gameModel.start);
+			if (error) {
+				printf("ERROR %d GRBsetdblattrarray(): %s\n", error, GRBgeterrormsg(env));
+			}
+		}
+		if(error) {
+			ret = -1;
+		}
+	}
+	/* ------------------- step3: Optimize and get the status ------------------- */
+	if(ret == TRUE) {
+		error = GRBoptimize(gameModel.model);
+		if (error) {
+			printf("ERROR %d GRBoptimize(): %s\n", error, GRBgeterrormsg(env));
+			ret = -1;
+		}
+	}
+	if(ret == TRUE) {
+		error = GRBgetintattr(gameModel.model, GRB_INT_ATTR_STATUS, &optimstatus);
+		if (error) {
+			printf("ERROR %d GRBgetintattr(): %s\n", error, GRBgeterrormsg(env));
+			ret = -1;
+		}
+	}
+	/* --------- step4: get the solution - it is also the start of the next call --------------- */
+	if(ret == TRUE) {
+		if(optimstatus == GRB_OPTIMAL) { /* Model is feasible. Solution found. */
+			error = GRBgetdblattrarray(gameModel.model, GRB_DBL_ATTR_X, 0, N3, gameModel.start);
+			if (error) {
+				printf("ERROR %d GRBgetdblattrarray(): %s\n", error, GRBgeterrormsg(env));
+				ret = -1;
+			}
+			else {
+				gameModel.hasStart = TRUE;
+				updateSolution(boardPtr,solBoardPtr,gameModel.start,gameModel.varIndex);
+			}
+		}
+		else { /* Model is infeasible. No solution found. */
+			ret = FALSE;
+		}
+	}
+
+	if(ret == -1) { /* the state of the model is unknown - build it again on the next call */
+		freeGameModel();
+	}
+	return ret;
+}
+
+
+/*
+ *  Frees the Gurobi environment of the calling thread, if it has one (and the model of the game).
+ *  Called by the main thread before the program exits - the environments of other threads are freed when they exit.
+ */
+void ilpFreeEnv() {
+	GRBenv*	env;
+
+	freeGameModel(); /* the model of the game is created in the environment of the main thread */
+	pthread_once(&ilpEnvOnce, createEnvKey);
+	env = (GRBenv*)pthread_getspecific(ilpEnvKey);
+	if(env != NULL) {
+		GRBfreeenv(env);
+		pthread_setspecific(ilpEnvKey, NULL);
+	}
+}
+
+
+/*
+ *  Returns TRUE - the program was built with the Gurobi library.
+ */
+unsigned int ilpAvailable() {
+	return TRUE;
+}
+
 /********************** End of public methods *********************/
 
 
@@ -163,19 +398,15 @@ unsigned int getIndex(unsigned int N, unsigned int row, unsigned int col, unsign
 
 
 /*
- * Creates a Gurobi environment and an empty model.
- * Also sets OutputFlag to 0, so there will be no prints to the console from Gurobi.
+ * Gets the Gurobi environment of the calling thread (see getGurobiEnv()) and creates an empty model.
  * Returns TRUE iff there were errors while using Gurobi.
  *
- * GRBenv* 		env			-	Gurobi envorinment.
+ * GRBenv** 	envPtr		-	A pointer to a Gurobi envorinment.
  * GRBmodel**	modelPtr	-	A pointer to a Gurobi model.
  */
 unsigned int createGurobiEnvModel(GRBenv **envPtr, GRBmodel **modelPtr){
 	unsigned int error;
-	/* Create environment - log file is mip1.log */
-	error = GRBloadenv(envPtr, "mip1.log");
-	if (error) {
-		printf("ERROR %d GRBloadenv(): %s\n", error, GRBgeterrormsg(*envPtr));
+	if(getGurobiEnv(envPtr)) {
 		return TRUE; /* Has an error */
 	}
 
@@ -185,39 +416,68 @@ unsigned int createGurobiEnvModel(GRBenv **envPtr, GRBmodel **modelPtr){
 		printf("ERROR %d GRBnewmodel(): %s\n", error, GRBgeterrormsg(*envPtr));
 		return TRUE; /* Has an error */
 	}
-
-	GRBsetintparam(GRBgetenv(*modelPtr),"OutputFlag",0);
 	return FALSE; /* No errors */
 }
 
 
+/*
+ * Maps the (row, column, value) triples of the board to the variables of the model:
+ * there is a variable for value v+1 of cell(r,c) iff the cell is empty and the value isn't used by its row,
+ * column or block. The other triples are known beforehand (the value of a filled cell is 1, the rest are 0),
+ * so they are left out of the model, with the constraints they satisfy.
+ * Returns the number of variables.
+ *
+ * Board*	boardPtr	-	A pointer a game board.
+ * int*		varIndex	-	varIndex[getIndex(N,r,c,v)] is set to the index of the variable of value v+1 in cell(r,c),
+ * 							or to -1 if there is no such variable (size: N^3).
+ */
+unsigned int mapVariables(Board* boardPtr, int* varIndex) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	r,c,v;
+	unsigned int	index, block;
+	unsigned int	numVars = 0;
+
+	for(r = 0; r < N; r++) {
+		for(c = 0; c < N; c++) {
+			block = getBlockIndex(boardPtr,r,c);
+			for(v = 0; v < N; v++) {
+				index = getIndex(N,r,c,v);
+				if(getCell(boardPtr,r,c)->value == 0 &&
+						!cand_contains(&boardPtr->rowsUsed[r], v+1) &&
+						!cand_contains(&boardPtr->colsUsed[c], v+1) &&
+						!cand_contains(&boardPtr->blocksUsed[block], v+1)) {
+					varIndex[index] = numVars++;
+				}
+				else {
+					varIndex[index] = -1;
+				}
+			}
+		}
+	}
+	return numVars;
+}
+
+
 /*
  * Initializes the objective function.
  * The objective function will be: Maximize 0.
- * The number of variables is set to be N^3 (x_(r,c,v) \forall r,c,v \in {0,...,N^3}).
+ * The variables are the legal values of the empty cells (see mapVariables()).
  *
  * GRBenv* 		env			-	Gurobi envorinment.
  * GRBmodel**	modelPtr	-	A pointer to a Gurobi model.
- * unsigned int	N			-	number of rows/columns.
- * char*		vtype		-	variable types (binary) (size: N^3).
+ * unsigned int	numVars		-	number of variables.
+ * char*		vtype		-	variable types (binary) (size: numVars).
  */
-unsigned int initObjectiveFunction(GRBenv *env, GRBmodel **modelPtr, unsigned int N, char* vtype){
-	unsigned int	N3 = N*N*N;
-	unsigned int	r,c,v;
+unsigned int initObjectiveFunction(GRBenv *env, GRBmodel **modelPtr, unsigned int numVars, char* vtype){
 	unsigned int	index;
 	unsigned int	error;
 
-	for(r=0; r < N; r++) {
-		for(c = 0; c < N; c++) {
-			for(v = 0; v < N; v++){
-				index = getIndex(N,r,c,v);
-				vtype[index]= GRB_BINARY;
-			}
-		}
+	for(index = 0; index < numVars; index++) {
+		vtype[index]= GRB_BINARY;
 	}
 
 	/* add variables to modelPtr */
-	error = GRBaddvars(*modelPtr, N3, 0, NULL, NULL, NULL, NULL, NULL, NULL, vtype, NULL);
+	error = GRBaddvars(*modelPtr, numVars, 0, NULL, NULL, NULL, NULL, NULL, NULL, vtype, NULL);
 	if (error) {
 		printf("ERROR %d GRBaddvars(): %s\n", error, GRBgeterrormsg(env));
 		return TRUE; /* has an error */
@@ -244,160 +504,183 @@ unsigned int initObjectiveFunction(GRBenv *env, GRBmodel **modelPtr, unsigned in
 /*
  * Adds all of the constraints needed for the model.
  * Constraint Types:
- * 	Type A: each cell has exactly  1 value.
- * 	type B: each column has exactly one of each value contained within it.
- * 	Type C: each row has exactly one of each value contained within it.
- * 	Type D: each block has exactly one of each value contained within it.
- * 	Type E: each non-empty cell has one value, that is known beforehand.
+ * 	Type A: each empty cell has exactly  1 value.
+ * 	type B: each column has exactly one of each value it doesn't contain yet.
+ * 	Type C: each row has exactly one of each value it doesn't contain yet.
+ * 	Type D: each block has exactly one of each value it doesn't contain yet.
+ * The filled cells, and the values their rows, columns and blocks already contain, satisfy their constraints,
+ * so these constraints are left out. A constraint with no variables (eg. an empty cell with no legal values)
+ * is still added - it can't be satisfied, so the model is infeasible.
+ *
+ * Each type is built in compressed sparse row form (see Constraints), and added by a single call to Gurobi.
+ * Every variable is in exactly one constraint of each type, so a type has at most N*N constraints,
+ * with numVars variables in all.
  *
  * GRBenv* 		env			-	Gurobi envorinment.
  * GRBmodel*	model		-	Gurobi model.
  * Board*		boardPtr	-	A pointer a game board.
- * unsigned int	m			-	number of rows in each block on the board.
- * unsigned int	n			-	number of columns in each block on the board.
+ * int*			varIndex	-	The variable of each cell and value, or -1 (size: N^3, see mapVariables()).
+ * unsigned int	numVars		-	number of variables.
  */
-unsigned int addConstraints(GRBenv *env, GRBmodel *model, Board* boardPtr, unsigned int m, unsigned int n) {
-	unsigned int 	r,c,v;
+unsigned int addConstraints(GRBenv *env, GRBmodel *model, Board* boardPtr, int* varIndex, unsigned int numVars) {
+	unsigned int 	r,c,v,i;
+	unsigned int	m = boardPtr->m, n = boardPtr->n;
 	unsigned int	N = m*n;
-	unsigned int 	index, error;
 	unsigned int	block;				/* for type D: Block constraints:*/
 	unsigned int	block_r, block_c;	/* for type D: Block constraints:*/
-	int*			ind;				/* stores the indices of the row/col/block constraints of the model (size: N).*/
-	double*			coefs;				/* stores the coefficients of the row/col/block constraints of the model (size: N).*/
-	int				nonEmptyCellInd[1];	/* for type E: non-empty cell: stores the index of a non-empty cell constraint. */
-	double			nonEmptyCellCoef[1];/* for type E: non-empty cell: stores the coefficient of a non-empty cell constraint.*/
+	Constraints		cons;				/* the constraints of the current type */
 	unsigned int	ret = FALSE;		/* return value. returns TRUE iff there WERE errors while adding constraints. */
 
-	/* Initialize coefficients for the constraints */
-	coefs = (double*)malloc(N*sizeof(double));
-	for(r = 0; r < N; r++) {
-		coefs[r] = 1;
-	}
-	if(coefs == NULL) {
+	/* Allocate the arrays (one more variable, so a full board doesn't allocate 0 bytes) */
+	cons.cbeg = (int*)malloc(N*N*sizeof(int));
+	cons.sense = (char*)malloc(N*N*sizeof(char));
+	cons.rhs = (double*)malloc(N*N*sizeof(double));
+	cons.cind = (int*)malloc((numVars+1)*sizeof(int));
+	cons.cval = (double*)malloc((numVars+1)*sizeof(double));
+	if(cons.cbeg == NULL || cons.sense == NULL || cons.rhs == NULL || cons.cind == NULL || cons.cval == NULL) {
 		printf("Error: malloc has failed\n");
 		exit(1);
 	}
-	/* indices for the constraints */
-	ind = (int*)malloc(N*sizeof(int));
-	if(ind == NULL) {
-		printf("Error: malloc has failed\n");
-		exit(1);
+	/* Every constraint is: sum of its variables = 1 */
+	for(i = 0; i < N*N; i++) {
+		cons.sense[i] = GRB_EQUAL;
+		cons.rhs[i] = 1.0;
+	}
+	for(i = 0; i < numVars; i++) {
+		cons.cval[i] = 1.0;
 	}
-	/* Type A: each cell has exactly one value */
+
+	/* Type A: each empty cell has exactly one value */
+	cons.numConstrs = 0; cons.numNz = 0;
 	for(r = 0; r < N; r++) {
 		for(c = 0; c < N; c++) {
+			if(getCell(boardPtr,r,c)->value != 0) continue; /* a filled cell */
+			cons.cbeg[cons.numConstrs++] = cons.numNz;
 			for(v = 0; v < N; v++) {
-				index = getIndex(N,r,c,v);
-				ind[v] = index;
-			}
-			/* Add constraint:*/
-			error = GRBaddconstr(model, N, ind, coefs, GRB_EQUAL, 1.0, NULL);
-			if (error) {
-				printf("ERROR %d GRBaddconstr(): %s\n", error, GRBgeterrormsg(env));
-				ret = TRUE;
+				addTerm(&cons, varIndex[getIndex(N,r,c,v)]);
 			}
 		}
 	}
+	ret = submitConstraints(env, model, &cons);
 
-	/* Type B: each column has exactly one of each value contained within it. */
+	/* Type B: each column has exactly one of each value it doesn't contain yet. */
 	if(!ret) {/* no errors yet */
+		cons.numConstrs = 0; cons.numNz = 0;
 		for(v = 0; v < N; v++) {
 			for(c = 0; c < N; c++) {
+				if(cand_contains(&boardPtr->colsUsed[c], v+1)) continue; /* the column contains the value */
+				cons.cbeg[cons.numConstrs++] = cons.numNz;
 				for(r = 0; r < N; r++) {
-					index = getIndex(N,r,c,v);
-					ind[r] = index;
-				}
-				/* Add constraint:*/
-				error = GRBaddconstr(model, N, ind, coefs, GRB_EQUAL, 1.0, NULL);
-				if (error) {
-					printf("ERROR %d GRBaddconstr(): %s\n", error, GRBgeterrormsg(env));
-					ret = TRUE;
+					addTerm(&cons, varIndex[getIndex(N,r,c,v)]);
 				}
 			}
 		}
+		ret = submitConstraints(env, model, &cons);
 	}
 
-	/* Type C: each row has exactly one of each value contained within it. */
+	/* Type C: each row has exactly one of each value it doesn't contain yet. */
 	if(!ret) {/* no errors yet */
+		cons.numConstrs = 0; cons.numNz = 0;
 		for(v = 0; v < N; v++) {
 			for(r = 0; r < N; r++) {
+				if(cand_contains(&boardPtr->rowsUsed[r], v+1)) continue; /* the row contains the value */
+				cons.cbeg[cons.numConstrs++] = cons.numNz;
 				for(c = 0; c < N; c++) {
-					index = getIndex(N,r,c,v);
-					ind[c] = index;
-				}
-				/* Add constraint:*/
-				error = GRBaddconstr(model, N, ind, coefs, GRB_EQUAL, 1.0, NULL);
-				if (error) {
-					printf("ERROR %d GRBaddconstr(): %s\n", error, GRBgeterrormsg(env));
-					ret = TRUE;
+					addTerm(&cons, varIndex[getIndex(N,r,c,v)]);
 				}
 			}
 		}
+		ret = submitConstraints(env, model, &cons);
 	}
 
 
-	/* Type D: each block has exactly one of each value contained within it. */
+	/* Type D: each block has exactly one of each value it doesn't contain yet. */
 	if(!ret) {/* no errors yet */
+		cons.numConstrs = 0; cons.numNz = 0;
 		for(v = 0; v < N; v++) {
 			for(block = 0; block < N; block++) {
+				if(cand_contains(&boardPtr->blocksUsed[block], v+1)) continue; /* the block contains the value */
+				cons.cbeg[cons.numConstrs++] = cons.numNz;
 				/* block's top-left cell's coordinates */
 				r = (block/m)*m;
 				c = (block%m)*n;
 				for(block_r = 0; block_r < m; block_r++) {
 					for(block_c = 0; block_c < n; block_c++) {
-						index = getIndex(N, r+block_r, c+block_c, v);
-						ind[block_r*n+block_c] = index; /* ind inside the block*/
+						addTerm(&cons, varIndex[getIndex(N, r+block_r, c+block_c, v)]);
 					}
 				}
-				/* Add constraint:*/
-				error = GRBaddconstr(model, N, ind, coefs, GRB_EQUAL, 1.0, NULL);
-				if (error) {
-					ret = TRUE;
-				}
 			}
 		}
+		ret = submitConstraints(env, model, &cons);
 	}
 
-	/* Type E: each non-empty cell has one value, that is known beforehand. */
-	if(!ret) {/* no errors yet */
-		nonEmptyCellCoef[0] = 1; /* Set the coefficient of all non-empty cell constraints to 1 */
-		for(r = 0; r < N; r++) {
-			for(c = 0; c < N; c++) {
-				v = getCell(boardPtr,r,c)->value; /* value between 0-N, 0 means empty cell. */
-				if(v > 0) { /* cell(r,c) is not empty */
-					index = getIndex(N,r,c,v-1); /* here a value of v translates to v-1 in the indices. */
-					nonEmptyCellInd[0] = index;
-					/* Add constraint */
-					error = GRBaddconstr(model, 1, nonEmptyCellInd, nonEmptyCellCoef, GRB_EQUAL,1.0, NULL);
-					if (error) {
-						printf("ERROR %d GRBaddconstr(): %s\n", error, GRBgeterrormsg(env));
-						ret = TRUE;
-					}
-				}
-			}
-		}
-	}
-	free(coefs);
-	free(ind);
+	free(cons.cbeg);
+	free(cons.sense);
+	free(cons.rhs);
+	free(cons.cind);
+	free(cons.cval);
 	return ret;
 }
 
 
 /*
- * Updates the solution board according to the optimized solution to the model.
+ * Adds a variable to the last constraint of a type, if the variable exists.
+ *
+ * Constraints*	cons	-	The constraints of the type.
+ * int			var		-	The index of the variable, or -1 if there is no such variable (see mapVariables()).
+ */
+void addTerm(Constraints* cons, int var) {
+	if(var >= 0) {
+		cons->cind[cons->numNz++] = var;
+	}
+}
+
+
+/*
+ * Adds the constraints of a type to the model, with a single call to Gurobi.
+ * Returns TRUE iff there were errors while using Gurobi.
  *
+ * GRBenv* 		env			-	Gurobi envorinment.
+ * GRBmodel*	model		-	Gurobi model.
+ * Constraints*	cons		-	The constraints of the type.
+ */
+unsigned int submitConstraints(GRBenv *env, GRBmodel *model, Constraints* cons) {
+	unsigned int	error;
+	if(cons->numConstrs == 0) { /* all the constraints of this type are satisfied */
+		return FALSE;
+	}
+	error = GRBaddconstrs(model, cons->numConstrs, cons->numNz, cons->cbeg, cons->cind, cons->cval,
+			cons->sense, cons->rhs, NULL);
+	if (error) {
+		printf("ERROR %d GRBaddconstrs(): %s\n", error, GRBgeterrormsg(env));
+		return TRUE; /* Has an error */
+	}
+	return FALSE; /* No errors */
+}
+
+/*
+ * Updates the solution board according to the optimized solution to the model:
+ * the filled cells keep their values, and each empty cell gets the value whose variable is 1.
+ *
+ * Board*		boardPtr	-	A pointer a game board.
  * Board*		solBoardPtr	-	A pointer to the solution board. used to update the solution board.
- * double*		sol			-	stores the solution values of the model (size: N^3).
- * unsigned int	N			-	number of rows/columns.
+ * double*		sol			-	stores the solution values of the model (size: number of variables).
+ * int*			varIndex	-	The variable of each cell and value, or -1 (size: N^3, see mapVariables()).
  */
-void updateSolution(Board* solBoardPtr, double* sol, unsigned int N) {
+void updateSolution(Board* boardPtr, Board* solBoardPtr, double* sol, int* varIndex) {
+	unsigned int N = boardPtr->m * boardPtr->n;
 	unsigned int r,c,v;
-	unsigned int index;
+	int var;
 	for(r = 0; r < N; r++) {
 		for(c = 0; c < N; c++) {
+			v = getCell(boardPtr,r,c)->value;
+			if(v != 0) { /* a filled cell */
+				setCellVal(solBoardPtr,r,c,v);
+				continue;
+			}
 			for(v = 0; v < N; v++) {
-				index = getIndex(N,r,c,v);
-				if(sol[index] == 1) {
+				var = varIndex[getIndex(N,r,c,v)];
+				if(var >= 0 && sol[var] > 0.5) { /* the variable is 1 (up to the tolerance of the solver) */
 					setCellVal(solBoardPtr,r,c,v+1);
 					break;
 				}
@@ -406,4 +689,223 @@ void updateSolution(Board* solBoardPtr, double* sol, unsigned int N) {
 	}
 }
 
+
+/*
+ * Returns (in envPtr) the Gurobi environment of the calling thread. On the first call of each thread - loads it:
+ * OutputFlag is set to 0, so there will be no prints to the console from Gurobi, and there is no log file
+ * (unless the SUDOKU_ILP_LOG environment variable names one).
+ * Returns TRUE iff there were errors while using Gurobi (the environment is then loaded again on the next call).
+ *
+ * GRBenv**	envPtr	-	A pointer to a Gurobi envorinment.
+ */
+unsigned int getGurobiEnv(GRBenv **envPtr) {
+	unsigned int	error;
+	char*			logFile = getenv(ILP_LOG_ENV_VARIABLE);
+
+	pthread_once(&ilpEnvOnce, createEnvKey);
+	*envPtr = (GRBenv*)pthread_getspecific(ilpEnvKey);
+	if(*envPtr != NULL) { /* loaded by a previous call */
+		return FALSE;
+	}
+
+	/* Create an empty environment, so the parameters are set before it is started */
+	error = GRBemptyenv(envPtr);
+	if (error) {
+		printf("ERROR %d GRBemptyenv(): %s\n", error, GRBgeterrormsg(*envPtr));
+		return TRUE; /* Has an error */
+	}
+	if(logFile != NULL) { /* log to the file only */
+		error = GRBsetintparam(*envPtr, GRB_INT_PAR_LOGTOCONSOLE, 0);
+		if (error) {
+			printf("ERROR %d GRBsetintparam(): %s\n", error, GRBgeterrormsg(*envPtr));
+		}
+		else {
+			error = GRBsetstrparam(*envPtr, GRB_STR_PAR_LOGFILE, logFile);	/* fails if the log file can't be opened */
+			if (error) {
+				printf("ERROR %d GRBsetstrparam(): %s\n", error, GRBgeterrormsg(*envPtr));
+			}
+		}
+	}
+	else {
+		error = GRBsetintparam(*envPtr, GRB_INT_PAR_OUTPUTFLAG, 0);
+		if (error) {
+			printf("ERROR %d GRBsetintparam(): %s\n", error, GRBgeterrormsg(*envPtr));
+		}
+	}
+	if (!error) {
+		error = GRBstartenv(*envPtr);
+		if (error) {
+			printf("ERROR %d GRBstartenv(): %s\n", error, GRBgeterrormsg(*envPtr));
+		}
+	}
+	if (error) {
+		GRBfreeenv(*envPtr);
+		*envPtr = NULL;
+		return TRUE; /* Has an error */
+	}
+	pthread_setspecific(ilpEnvKey, *envPtr);
+	return FALSE; /* No errors */
+}
+
+
+/*
+ * Creates the key of the Gurobi environments of the threads. Called once (see pthread_once()).
+ */
+void createEnvKey() {
+	pthread_key_create(&ilpEnvKey, freeThreadEnv);
+}
+
+
+/*
+ * Frees the Gurobi environment of a thread that exits (the destructor of the key).
+ *
+ * void*	env		-	The Gurobi environment of the thread (not NULL).
+ */
+void freeThreadEnv(void* env) {
+	GRBfreeenv((GRBenv*)env);
+}
+
+/*
+ * Builds the model of the game (see ilpSolveGame()) for boards with blocks of m rows and n columns:
+ * the model of an empty board - a variable for every cell and value, and all of the constraints.
+ * Returns TRUE iff there were errors while using Gurobi.
+ *
+ * GRBenv* 		env		-	The Gurobi envorinment of the main thread.
+ * unsigned int	m		-	number of rows in each block on the board.
+ * unsigned int	n		-	number of columns in each block on the board.
+ */
+unsigned int createGameModel(GRBenv *env, unsigned int m, unsigned int n) {
+	Board			emptyBoard = {'\0'};
+	unsigned int	N = m*n;
+	unsigned int	N3 = N*N*N;
+	unsigned int	i;
+	unsigned int	error;
+	char*			vtype;
+
+	gameModel.m = m;
+	gameModel.n = n;
+	gameModel.hasStart = FALSE;
+	gameModel.varIndex = (int*)malloc(N3*sizeof(int));
+	gameModel.lb = (double*)malloc(N3*sizeof(double));
+	gameModel.ub = (double*)malloc(N3*sizeof(double));
+	gameModel.start = (double*)malloc(N3*sizeof(double));
+	vtype = (char*)malloc(N3*sizeof(char));
+	if(gameModel.varIndex == NULL || gameModel.lb == NULL || gameModel.ub == NULL || gameModel.start == NULL || vtype == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	/* the bounds of new variables (binary variables keep their infinite upper bound until it is set) */
+	for(i = 0; i < N3; i++) {
+		gameModel.lb[i] = 0.0;
+		gameModel.ub[i] = GRB_INFINITY;
+	}
+
+	/* every value of every cell of an empty board is legal - the variables are all the (row, column, value) triples */
+	initializeBoard(&emptyBoard, m, n);
+	mapVariables(&emptyBoard, gameModel.varIndex);
+	error = GRBnewmodel(env, &gameModel.model, "mip1", 0, NULL, NULL, NULL, NULL, NULL);
+	if (error) {
+		printf("ERROR %d GRBnewmodel(): %s\n", error, GRBgeterrormsg(env));
+	}
+	else {
+		error = initObjectiveFunction(env, &gameModel.model, N3, vtype) ||
+				addConstraints(env, gameModel.model, &emptyBoard, gameModel.varIndex, N3);
+	}
+	freeBoard(&emptyBoard);
+	free(vtype);
+	return error ? TRUE : FALSE;
+}
+
+
+/*
+ * Frees the model of the game (see ilpSolveGame()), if there is one.
+ */
+void freeGameModel() {
+	GRBfreemodel(gameModel.model);
+	free(gameModel.varIndex);
+	free(gameModel.lb);
+	free(gameModel.ub);
+	free(gameModel.start);
+	gameModel.model = NULL;
+	gameModel.varIndex = NULL;
+	gameModel.lb = gameModel.ub = gameModel.start = NULL;
+	gameModel.hasStart = FALSE;
+}
+
+
+/*
+ * Sets the bounds of the variables of the model of the game to a board: the value of a filled cell is fixed to 1
+ * and its other values to 0, and so are the illegal values of the empty cells (used by their row, column or block).
+ * Only the bounds that changed since the last call are passed to Gurobi.
+ * Returns TRUE iff there were errors while using Gurobi.
+ *
+ * GRBenv* 		env			-	The Gurobi envorinment of the main thread.
+ * Board*		boardPtr	-	A pointer a game board (of the geometry of the model).
+ */
+unsigned int updateBounds(GRBenv *env, Board* boardPtr) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	N3 = N*N*N;
+	unsigned int	r,c,v,val,block,index;
+	int*			lbInd;				/* the variables whose lower bound changed */
+	double*			lbVal;				/* their new lower bounds */
+	int*			ubInd;				/* the variables whose upper bound changed */
+	double*			ubVal;				/* their new upper bounds */
+	int				numLb = 0, numUb = 0;
+	double			lb, ub;
+	unsigned int	error = 0;
+
+	lbInd = (int*)malloc(N3*sizeof(int));
+	lbVal = (double*)malloc(N3*sizeof(double));
+	ubInd = (int*)malloc(N3*sizeof(int));
+	ubVal = (double*)malloc(N3*sizeof(double));
+	if(lbInd == NULL || lbVal == NULL || ubInd == NULL || ubVal == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+
+	for(r = 0; r < N; r++) {
+		for(c = 0; c < N; c++) {
+			val = getCell(boardPtr,r,c)->value;
+			block = getBlockIndex(boardPtr,r,c);
+			for(v = 0; v < N; v++) {
+				index = getIndex(N,r,c,v);
+				if(val != 0) { /* a filled cell - only its value is 1 */
+					lb = ub = (val == v+1) ? 1.0 : 0.0;
+				}
+				else { /* an empty cell - its illegal values are 0 */
+					lb = 0.0;
+					ub = (cand_contains(&boardPtr->rowsUsed[r], v+1) ||
+							cand_contains(&boardPtr->colsUsed[c], v+1) ||
+							cand_contains(&boardPtr->blocksUsed[block], v+1)) ? 0.0 : 1.0;
+				}
+				if(gameModel.lb[index] != lb) {
+					lbInd[numLb] = index;
+					lbVal[numLb++] = gameModel.lb[index] = lb;
+				}
+				if(gameModel.ub[index] != ub) {
+					ubInd[numUb] = index;
+					ubVal[numUb++] = gameModel.ub[index] = ub;
+				}
+			}
+		}
+	}
+
+	if(numLb > 0) {
+		error = GRBsetdblattrlist(gameModel.model, GRB_DBL_ATTR_LB, numLb, lbInd, lbVal);
+	}
+	if(!error && numUb > 0) {
+		error = GRBsetdblattrlist(gameModel.model, GRB_DBL_ATTR_UB, numUb, ubInd, ubVal);
+	}
+	if (error) {
+		printf("ERROR %d GRBsetdblattrlist(): %s\n", error, GRBgeterrormsg(env));
+	}
+	free(lbInd);
+	free(lbVal);
+	free(ubInd);
+	free(ubVal);
+	return error ? TRUE : FALSE;
+}
+
 /********************** End of private methods *********************/
+
+#endif /* NO_GUROBI */
@@ -1,15 +1,43 @@
 /*---ILP_Solver.h---
  * This module uses the Gurobi Optimizer Integer Linear Programming solver.
  * It is being used in order to solve puzzles and check possible solutions to them.
- * The module includes one public function - ilpSolve().
+ * The module includes four public functions - ilpSolve(), ilpSolveGame(), ilpFreeEnv() and ilpAvailable().
+ * Each thread loads a Gurobi environment on its first call to ilpSolve(), and reuses it for the rest of its calls.
  */
 
 /*
  *  Solve a game board and update its solution board,
  *  using Integer Linear Programming (ILP) with the Gurobi library.
- *  return TRUE iff board is solvable.
+ *  return TRUE iff board is solvable (-1 on Gurobi failure).
  *
  *  Board*	boardPtr	-	A pointer a game board.
  *  Board*	solBoardPtr	-	A pointer to the solution board. used to update the solution board.
  */
 int ilpSolve(Board*, Board*);
+
+
+/*
+ *  Solve the board of the game and update its solution board, like ilpSolve() - but with the model of the game,
+ *  which is kept between the calls: it is built once for the geometry of the board, and each call only changes
+ *  the bounds of the variables that changed since the last call. The last solution found is the MIP start of the next call.
+ *  return TRUE iff board is solvable (-1 on Gurobi failure).
+ *
+ *  Used by the main thread only (the model is not shared with the worker threads).
+ *
+ *  Board*	boardPtr	-	A pointer a game board.
+ *  Board*	solBoardPtr	-	A pointer to the solution board. used to update the solution board.
+ */
+int ilpSolveGame(Board*, Board*);
+
+
+/*
+ *  Frees the Gurobi environment of the calling thread, if it has one (and the model of the game).
+ *  Called by the main thread before the program exits - the environments of other threads are freed when they exit.
+ */
+void ilpFreeEnv();
+
+
+/*
+ *  Returns TRUE iff the program was built with the Gurobi library (FALSE if built with NO_GUROBI defined).
+ */
+unsigned int ilpAvailable();
@@ -0,0 +1,130 @@
+/*---KernelTemplate.h---
+ * The counting kernel of a single board geometry. This file has no include guard on purpose:
+ * Kernels.c includes it once per geometry and instruction set, after defining
+ * 	KERNEL_M			-	number of rows in each block.
+ * 	KERNEL_N			-	number of columns in each block.
+ * 	KERNEL_NAME			-	the name of the generated function.
+ * 	KERNEL_TARGET		-	attributes of the generated function (the instruction set it may use), or nothing.
+ * 	KERNEL_COUNT(word)	-	the number of bits turned on in a word.
+ * and the macros are undefined at the end of the file.
+ *
+ * The kernel is an exhaustive backtracking search with the MRV (minimum remaining values) order:
+ * the empty cells are kept in an array, where the first depth cells are the ones assigned so far.
+ * At each depth - the remaining cell with the least possible values is swapped into place and its values are tried
+ * in increasing order. The values used by each row, column and block are single words (bit v-1 stands for value v).
+ */
+
+#define KERNEL_SIZE			(KERNEL_M * KERNEL_N)						/* N */
+#define KERNEL_CELLS		(KERNEL_SIZE * KERNEL_SIZE)					/* N*N */
+#define KERNEL_ALL			((1UL << KERNEL_SIZE) - 1)					/* the set {1,...,N} */
+#define KERNEL_ROW(cell)	((cell) / KERNEL_SIZE)
+#define KERNEL_COL(cell)	((cell) % KERNEL_SIZE)
+#define KERNEL_BLOCK(cell)	((KERNEL_ROW(cell) / KERNEL_M) * KERNEL_M + KERNEL_COL(cell) / KERNEL_N)
+
+
+/*
+ * Calculates the number of solutions for a board of the kernel's geometry (up to limit, if limit > 0).
+ *
+ * Board*			boardPtr	-	A pointer to a game board.
+ * unsigned int		limit		-	The maximal number of solutions to count (0 for no limit).
+ */
+KERNEL_TARGET unsigned int KERNEL_NAME(Board* boardPtr, unsigned int limit) {
+	unsigned long	rowsUsed[KERNEL_SIZE], colsUsed[KERNEL_SIZE], blocksUsed[KERNEL_SIZE];
+	unsigned int	empty[KERNEL_CELLS];		/* the empty cells (row*N+col) - empty[0] to empty[depth-1] are assigned */
+	unsigned long	remaining[KERNEL_CELLS];	/* remaining[d] - the values of empty[d] that weren't tried yet */
+	unsigned long	assigned[KERNEL_CELLS];		/* assigned[d] - the value assigned to empty[d] (as a single bit) */
+	unsigned int	numEmpty = 0, depth = 0, counter = 0;
+	unsigned int	cell, i, best, bestCount, count;
+	unsigned int	choose, value;
+	unsigned long	possible, bestPossible, bit;
+
+	/* the values used by the rows, columns and blocks, and the empty cells */
+	for(i = 0; i < KERNEL_SIZE; i++) {
+		rowsUsed[i] = colsUsed[i] = blocksUsed[i] = 0;
+	}
+	for(cell = 0; cell < KERNEL_CELLS; cell++) {
+		value = getCell(boardPtr, KERNEL_ROW(cell), KERNEL_COL(cell))->value;
+		if(value == 0) {
+			empty[numEmpty++] = cell;
+		}
+		else {
+			bit = 1UL << (value - 1);
+			rowsUsed[KERNEL_ROW(cell)] |= bit;
+			colsUsed[KERNEL_COL(cell)] |= bit;
+			blocksUsed[KERNEL_BLOCK(cell)] |= bit;
+		}
+	}
+	if(numEmpty == 0) {
+		return 1; /* the board is already solved */
+	}
+
+	choose = TRUE;
+	while(TRUE) {
+		if(choose) { /* a new depth - move the remaining cell with the least possible values to empty[depth] */
+			bestCount = KERNEL_SIZE + 1;
+			best = depth;
+			bestPossible = 0;
+			for(i = depth; i < numEmpty && bestCount > 1; i++) {
+				cell = empty[i];
+				possible = KERNEL_ALL & ~(rowsUsed[KERNEL_ROW(cell)] | colsUsed[KERNEL_COL(cell)] | blocksUsed[KERNEL_BLOCK(cell)]);
+				count = KERNEL_COUNT(possible);
+				if(count < bestCount) {
+					best = i;
+					bestCount = count;
+					bestPossible = possible;
+				}
+			}
+			cell = empty[best];
+			empty[best] = empty[depth];
+			empty[depth] = cell;
+			remaining[depth] = bestPossible; /* empty if the cell has no possible values - a dead end */
+			choose = FALSE;
+
+			if(depth + 1 == numEmpty) { /* the last empty cell - each of its possible values completes a solution */
+				counter += bestCount;
+				if(limit > 0 && counter >= limit) {
+					counter = limit;
+					break;
+				}
+				remaining[depth] = 0;
+			}
+		}
+
+		if(remaining[depth] == 0) { /* all the values of this cell were tried - go back to the previous cell */
+			if(depth == 0) {
+				break;
+			}
+			depth--;
+			cell = empty[depth];
+			rowsUsed[KERNEL_ROW(cell)] &= ~assigned[depth];
+			colsUsed[KERNEL_COL(cell)] &= ~assigned[depth];
+			blocksUsed[KERNEL_BLOCK(cell)] &= ~assigned[depth];
+			continue;
+		}
+
+		/* try the smallest remaining value */
+		bit = remaining[depth] & (~remaining[depth] + 1);
+		remaining[depth] &= ~bit;
+		cell = empty[depth];
+		assigned[depth] = bit;
+		rowsUsed[KERNEL_ROW(cell)] |= bit;
+		colsUsed[KERNEL_COL(cell)] |= bit;
+		blocksUsed[KERNEL_BLOCK(cell)] |= bit;
+		depth++;
+		choose = TRUE;
+	}
+	return counter;
+}
+
+
+#undef KERNEL_SIZE
+#undef KERNEL_CELLS
+#undef KERNEL_ALL
+#undef KERNEL_ROW
+#undef KERNEL_COL
+#undef KERNEL_BLOCK
+#undef KERNEL_M
+#undef KERNEL_N
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#undef KERNEL_COUNT
@@ -0,0 +1,182 @@
+/*---Kernels.c---
+ * This module counts the solutions of boards of the common geometries - blocks of 3x3, 4x4 and 5x5 cells
+ * (9x9, 16x16 and 25x25 boards) - with kernels specialized for each geometry at compile time.
+ * The kernels are generated from KernelTemplate.h, which is included once per geometry.
+ *
+ * Most of the time of a kernel is spent counting the possible values of cells. On x86 processors that support
+ * the POPCNT instruction (SSE4.2 and later), each kernel is also compiled to use it - the generic x86 build
+ * can't assume it, so the portable kernels count the bits with arithmetic (see countBits()).
+ * The kernels to use are selected at runtime, by the processor's features (CPUID).
+ * Elsewhere, only the portable kernels are compiled.
+ *
+ * A. Private functions:
+ * 	1. countBits()					:	Returns the number of values in a set of values (a single word).
+ * 	2. numSolutions3x3()			:	The kernel of boards with blocks of 3x3 cells.
+ * 	3. numSolutions4x4()			:	The kernel of boards with blocks of 4x4 cells.
+ * 	4. numSolutions5x5()			:	The kernel of boards with blocks of 5x5 cells.
+ * 	5. numSolutions3x3Popcnt()		:	The kernel of boards with blocks of 3x3 cells, using POPCNT.
+ * 	6. numSolutions4x4Popcnt()		:	The kernel of boards with blocks of 4x4 cells, using POPCNT.
+ * 	7. numSolutions5x5Popcnt()		:	The kernel of boards with blocks of 5x5 cells, using POPCNT.
+ * 	8. hasPopcnt()					:	Returns TRUE iff the processor supports the POPCNT instruction.
+ *
+ * B. Public functions:
+ * 	1. hasKernel()					:	Returns TRUE iff there is a specialized kernel for a geometry.
+ * 	2. kernelNumSolutions()			:	Calculates the number of solutions for a board (up to a limit) with the kernel of its geometry.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Kernels.h"
+
+/* the POPCNT kernels are compiled by GCC (and compatible compilers) for x86 processors only */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POPCNT_KERNELS
+#endif
+
+
+/********** Private method declarations **********/
+
+unsigned int	countBits(unsigned long);
+unsigned int	numSolutions3x3(Board*, unsigned int);
+unsigned int	numSolutions4x4(Board*, unsigned int);
+unsigned int	numSolutions5x5(Board*, unsigned int);
+#ifdef POPCNT_KERNELS
+unsigned int	numSolutions3x3Popcnt(Board*, unsigned int);
+unsigned int	numSolutions4x4Popcnt(Board*, unsigned int);
+unsigned int	numSolutions5x5Popcnt(Board*, unsigned int);
+unsigned int	hasPopcnt();
+#endif
+
+/******* End of private method declarations ******/
+
+
+
+/************************* Public methods *************************/
+
+/*
+ * Returns TRUE iff there is a specialized kernel for boards with blocks of m rows and n columns.
+ *
+ * unsigned int	m	-	Number of rows in each block.
+ * unsigned int	n	-	Number of columns in each block.
+ */
+unsigned int hasKernel(unsigned int m, unsigned int n) {
+	return m == n && m >= 3 && m <= 5;
+}
+
+
+/*
+ * Calculates the number of solutions for a board with the kernel of its geometry.
+ * Stops counting once limit solutions were found (if limit > 0), and returns limit.
+ *
+ * pre: hasKernel(boardPtr->m, boardPtr->n)
+ * pre: the board has no erroneous cells
+ *
+ * Board*			boardPtr	-	A pointer to a game board.
+ * unsigned int		limit		-	The maximal number of solutions to count (0 for no limit).
+ */
+unsigned int kernelNumSolutions(Board* boardPtr, unsigned int limit) {
+#ifdef POPCNT_KERNELS
+	if(hasPopcnt()) {
+		switch(boardPtr->m) {
+		case 3:
+			return numSolutions3x3Popcnt(boardPtr, limit);
+		case 4:
+			return numSolutions4x4Popcnt(boardPtr, limit);
+		default:
+			return numSolutions5x5Popcnt(boardPtr, limit);
+		}
+	}
+#endif
+	switch(boardPtr->m) {
+	case 3:
+		return numSolutions3x3(boardPtr, limit);
+	case 4:
+		return numSolutions4x4(boardPtr, limit);
+	default:
+		return numSolutions5x5(boardPtr, limit);
+	}
+}
+
+/********************** End of public methods *********************/
+
+
+
+/************************* Private methods *************************/
+
+/*
+ * Returns the number of values in a set of at most 32 values, ie. the number of bits turned on in a word.
+ * The bits are summed in parallel (in pairs, then nibbles, then bytes) - unlike a popcount library call,
+ * this is compiled inline, and it is used for every cell the kernels consider.
+ *
+ * unsigned long	word	-	Said set.
+ */
+unsigned int countBits(unsigned long word) {
+	word = word - ((word >> 1) & 0x55555555UL);
+	word = (word & 0x33333333UL) + ((word >> 2) & 0x33333333UL);
+	word = (word + (word >> 4)) & 0x0F0F0F0FUL;
+	return (unsigned int)(((word * 0x01010101UL) >> 24) & 0xFF);
+}
+
+
+/* The portable kernels (see KernelTemplate.h) */
+
+#define KERNEL_M			3
+#define KERNEL_N			3
+#define KERNEL_NAME			numSolutions3x3
+#define KERNEL_TARGET
+#define KERNEL_COUNT(word)	countBits(word)
+#include "KernelTemplate.h"
+
+#define KERNEL_M			4
+#define KERNEL_N			4
+#define KERNEL_NAME			numSolutions4x4
+#define KERNEL_TARGET
+#define KERNEL_COUNT(word)	countBits(word)
+#include "KernelTemplate.h"
+
+#define KERNEL_M			5
+#define KERNEL_N			5
+#define KERNEL_NAME			numSolutions5x5
+#define KERNEL_TARGET
+#define KERNEL_COUNT(word)	countBits(word)
+#include "KernelTemplate.h"
+
+
+#ifdef POPCNT_KERNELS
+
+/* The POPCNT kernels - the same kernels, where the compiler may use the POPCNT instruction for __builtin_popcountl() */
+
+#define KERNEL_M			3
+#define KERNEL_N			3
+#define KERNEL_NAME			numSolutions3x3Popcnt
+#define KERNEL_TARGET		__attribute__((target("popcnt")))
+#define KERNEL_COUNT(word)	((unsigned int)__builtin_popcountl(word))
+#include "KernelTemplate.h"
+
+#define KERNEL_M			4
+#define KERNEL_N			4
+#define KERNEL_NAME			numSolutions4x4Popcnt
+#define KERNEL_TARGET		__attribute__((target("popcnt")))
+#define KERNEL_COUNT(word)	((unsigned int)__builtin_popcountl(word))
+#include "KernelTemplate.h"
+
+#define KERNEL_M			5
+#define KERNEL_N			5
+#define KERNEL_NAME			numSolutions5x5Popcnt
+#define KERNEL_TARGET		__attribute__((target("popcnt")))
+#define KERNEL_COUNT(word)	((unsigned int)__builtin_popcountl(word))
+#include "KernelTemplate.h"
+
+
+/*
+ * Returns TRUE iff the processor supports the POPCNT instruction.
+ * The processor is queried (CPUID) once, when the program starts - this only reads the result,
+ * so it is cheap and safe to call from the worker threads of the parallel counting.
+ */
+unsigned int hasPopcnt() {
+	return __builtin_cpu_supports("popcnt") ? TRUE : FALSE;
+}
+
+#endif /* POPCNT_KERNELS */
+
+/********************** End of private methods *********************/
@@ -0,0 +1,42 @@
+/*---Kernels.h---
+ * This module counts the solutions of boards of the common geometries - blocks of 3x3, 4x4 and 5x5 cells
+ * (9x9, 16x16 and 25x25 boards) - with kernels specialized for each geometry at compile time.
+ *
+ * Each kernel is the same backtracking search (see KernelTemplate.h), compiled with the block sizes as constants:
+ * the number of cells, the row/column/block of a cell and the set of all values are known to the compiler,
+ * and the values used by each row, column and block are kept in a single machine word.
+ * Boards of other geometries are counted by the generic methods of Solver.c.
+ *
+ * The module includes 2 functions:
+ * 	1. hasKernel()				:	Returns TRUE iff there is a specialized kernel for a geometry.
+ * 	2. kernelNumSolutions()		:	Calculates the number of solutions for a board (up to a limit) with the kernel of its geometry.
+ */
+
+#include "Game.h"
+
+#ifndef KERNELS_H_
+#define KERNELS_H_
+
+
+/*
+ * Returns TRUE iff there is a specialized kernel for boards with blocks of m rows and n columns.
+ *
+ * unsigned int	m	-	Number of rows in each block.
+ * unsigned int	n	-	Number of columns in each block.
+ */
+unsigned int	hasKernel(unsigned int, unsigned int);
+
+
+/*
+ * Calculates the number of solutions for a board with the kernel of its geometry.
+ * Stops counting once limit solutions were found (if limit > 0), and returns limit.
+ *
+ * pre: hasKernel(boardPtr->m, boardPtr->n)
+ * pre: the board has no erroneous cells
+ *
+ * Board*			boardPtr	-	A pointer to a game board.
+ * unsigned int		limit		-	The maximal number of solutions to count (0 for no limit).
+ */
+unsigned int	kernelNumSolutions(Board*, unsigned int);
+
+#endif /* KERNELS_H_ */
@@ -6,7 +6,7 @@
  *
  * Functions:
  * 	1. repeatChar()    			:	Repeats the character c n times in string out.
- * 	2. printCellRow() 			:	Prints a specific row of boardPtr->board
+ * 	2. renderCellRow() 			:	Renders a specific row of boardPtr->board to a buffer
  * 	3. printBoard()    			:	Prints the game board.
  *	4. handleBoardCompletion () :	Checks if the board is complete and prints a message accordingly
  *
@@ -20,17 +20,19 @@
  *		 					 		returns TRUE iff the game mode is SOLVE.
  *	8.  executePrintBoard() 	:	Prints the game board.
  *	9.  executeSet()      		:	Tries to set a new value to a cell.
- *	10. executeValidate()		:	Validates game using ILP, if the game doesn't contain erroneous values.
- *	11. executeGenerate()		:	Generates a puzzle by randomly filling X cells with random legal values,
- * 									running ILP to solve the resulting board, and then clearing all but Y random cells.
+ *	10. executeValidate()		:	Validates game (see validate() in Solver.h), if the game doesn't contain erroneous values.
+ *	11. executeGenerate()		:	Generates a puzzle by building a random solved board (a shuffled pattern),
+ * 									and then clearing all but Y random cells (X is range-checked only).
  *	12. executeUndo()    		:	Undo previous move done by the player.
  *	13. executeRedo()    		:	Redo a move previously done by the player.
  *	14. executeSave()     		:	If given a valid path, saves the current game board to the given path address.
  *	15. executeHint()     		:	Give a hint to the player by showing the solution of a single cell[row,col].
- *	16. executeNumSolutions ()	:	Prints the number of solutions for the current board, but only if the board does not contain erroneous values
+ *	16. executeNumSolutions ()	:	Prints the number of solutions for the current board (up to an optional limit),
+ *									but only if the board does not contain erroneous values
  *	17. executeAutofill()		:	Automatically fills "obvious" values -- cells which contain a single legal value.
  *	18. executeReset()			:	Undos all modes, reverting the board to its original loaded state.
  *	19. executeExit() 			:	Frees all memory resources, and terminate the program in the main module
+ *	20. executeSolver()			:	Selects the solver backend by its name, or prints the backends in use if no name was given.
  *
  */
 
@@ -40,6 +42,7 @@
 #include <stdlib.h>
 #include "Solver.h"
 #include "FileManager.h"
+#include "Parser.h"
 #include "ILP_Solver.h"
 
 Board			gameBoard;
@@ -62,10 +65,11 @@ void printBoard(Board*);
 /* 9 */ unsigned int executeRedo();
 /* 10*/ unsigned int executeSave(char*);
 /* 11*/ unsigned int executeHint(int,int);
-/* 12*/ unsigned int executeNumSolutions();
+/* 12*/ unsigned int executeNumSolutions(int);
 /* 13*/ unsigned int executeAutofill();
 /* 14*/ unsigned int executeReset();
 /* 15*/ unsigned int executeExit();
+/* 16*/ unsigned int executeSolver(char*);
 
 /******* End of private method declarations ******/
 
@@ -77,7 +81,7 @@ void printBoard(Board*);
  * returns TRUE iff command executed successfully.
  *
  * unsigned int*	command		-	The already encoded user command (after interpretation).
- * char*			path		-	A file path (used by edit, solve, and save commands).
+ * char*			path		-	A file path (used by edit, solve, and save commands), or a backend name (used by the solver command).
  */
 unsigned int executeCommand (int* command, char* path){
 	switch(command[0]) {
@@ -104,13 +108,15 @@ unsigned int executeCommand (int* command, char* path){
 	case 11: 	/*	HINT	*/
 		return executeHint(command[2]-1, command[1]-1);
 	case 12:	/* NUM SOLUTIONS */
-		return executeNumSolutions();
+		return executeNumSolutions(command[1]);
 	case 13:	/* AUTOFILL */
 		return executeAutofill();
 	case 14:	/* RESET */
 		return executeReset();
 	case 15: 	/*	EXIT	*/
 		return executeExit();
+	case 16:	/* SOLVER */
+		return executeSolver(path);
 	default:	/* an empty input would reach this */
 		return TRUE;
 	}/*switch-end*/
@@ -126,7 +132,7 @@ unsigned int executeCommand (int* command, char* path){
 
 
 /*
- * Repeats the character c n times in string out.
+ * Repeats the character c n times in string out, followed by '\n' (out is not null terminated).
  * Used for making the separator row for printing the board.
  *
  * char	c			-	The character to be repeated.
@@ -144,76 +150,81 @@ void repeatChar(char c, unsigned int n, char* out) {
 
 
 /*
- * Prints a specific row of boardPtr->board.
+ * Renders a specific row of boardPtr->board to out (ending with '\n'), and returns the number of characters rendered.
  *
  * Board*		boardPtr	-	A pointer to a game board.
- * unsigned int row			-	The row to be printed.
+ * unsigned int row			-	The row to be rendered.
+ * unsigned int markErrors	-	TRUE iff erroneous cells are marked (with an asterisk).
+ * char*		out			-	The buffer the row is rendered to.
  */
-void printCellRow(Board* boardPtr, unsigned int row) {
+unsigned int renderCellRow(Board* boardPtr, unsigned int row, unsigned int markErrors, char* out) {
 	unsigned int	m = boardPtr->m, n = boardPtr->n;
 	unsigned int	col;
 	unsigned int	block;
 	Cell*			cell;
-	printf("|");
+	char*			pos = out;
+	*pos++ = '|';
 	/* For each block row */
 	for(block = 0; block < m; block++) {
 		/* For each block column: */
 		for(col = block*n; col < block*n + n; col++) {
 			cell = getCell(boardPtr,row,col);
-			printf(" ");
-			if(cell->value == 0){
-				printf("  ");
-			}
-			else {
-				printf("%2d", cell->value);
-			}
+			*pos++ = ' ';
+			/* the value - 2 characters, right aligned */
+			*pos++ = (cell->value >= 10) ? '0' + cell->value/10 : ' ';
+			*pos++ = (cell->value > 0) ? '0' + cell->value%10 : ' ';
 			if(cell->fixed) {
-				printf(".");
+				*pos++ = '.';
 			}
-			else if((getGameMode() == EDIT || getMarkErrors()) && cell->isErroneous) {
-				printf("*");
+			else if(markErrors && isErroneous(boardPtr,row,col)) {
+				*pos++ = '*';
 			}
 			else {
-				printf(" ");
+				*pos++ = ' ';
 			}
 		}
-		printf("|");
+		*pos++ = '|';
 	}
-	printf("\n");
+	*pos++ = '\n';
+	return pos - out;
 }
 
 
 /*
  * Prints the game board.
+ * The board is rendered to a single buffer first, and printed with a single write
+ * (stdout is unbuffered - see SPBufferset.h - so each print call is a system call).
  *
  * Board*	boardPtr	-	A pointer to a game board.
  */
 void printBoard(Board* boardPtr) {
 	unsigned int		m = boardPtr->m, n = boardPtr->n;
 	unsigned int		N = m*n;
-	char*				separatorRow;
+	unsigned int		markErrors = (getGameMode() == EDIT || getMarkErrors());
+	char				*buffer, *pos;
 	unsigned int		i,j;
-	static unsigned int	sepSize;
+	unsigned int		sepSize = 4*N + m + 1;	/* each row (cells or separator) has sepSize characters and '\n' */
 
-	sepSize = 4*N + m + 1;
-	separatorRow = (char*) malloc((sepSize+2)*sizeof(char)); /* allocate enough space for the number of '-' characters needed + '\n' + '\0'. */
-	if(separatorRow == NULL) {
+	/* N rows of cells and n+1 separator rows */
+	buffer = (char*) malloc((N + n + 1)*(sepSize + 1)*sizeof(char));
+	if(buffer == NULL) {
 		printf("Error: malloc has failed\n");
 		exit(1);
 	}
-	separatorRow[sepSize+1] = '\0';
-	repeatChar('-',sepSize,separatorRow);
-
-	printf("%s",separatorRow);
+	pos = buffer;
+	repeatChar('-',sepSize,pos);
+	pos += sepSize + 1;
 
 	for(i = 0; i < n; i++) {
 		for(j = 0; j < m; j++) {
-			printCellRow(boardPtr, i*m+j);
+			pos += renderCellRow(boardPtr, i*m+j, markErrors, pos);
 		}
-		printf("%s",separatorRow);
+		repeatChar('-',sepSize,pos);
+		pos += sepSize + 1;
 	}
 
-	free(separatorRow);
+	fwrite(buffer, sizeof(char), pos - buffer, stdout);
+	free(buffer);
 }
 
 
@@ -253,11 +264,13 @@ unsigned int executeSolve(char* path) {
 		return FALSE;
 	}
 	/* Try to load board from file path, if failed to load - print error. */
-	loadSuccessful = loadBoard(&gameBoard, path, SOLVE);
+	loadSuccessful = loadBoard(&gameBoard, &solutionBoard, path, SOLVE);
 	if(loadSuccessful) {
 		setGameMode(SOLVE);
 		initializeMoveList();
-		initializeBoard(&solutionBoard, gameBoard.m, gameBoard.n);
+		if(!isBoardEmpty(solutionBoard)) { /* the file has a solution - no need to solve the puzzle again */
+			setSolutionCurrent();
+		}
 		printBoard(&gameBoard);
 	}
 	else {
@@ -288,11 +301,13 @@ unsigned int executeEdit(char* path) {
 	}
 	else {
 		/* Try to load board from file path, if failed to load - print error. */
-		loadSuccessful = loadBoard(&gameBoard, path, EDIT);
+		loadSuccessful = loadBoard(&gameBoard, &solutionBoard, path, EDIT);
 		if(loadSuccessful) {
 			setGameMode(EDIT);
-			initializeBoard(&solutionBoard, gameBoard.m, gameBoard.n);
 			initializeMoveList();
+			if(!isBoardEmpty(solutionBoard)) { /* the file has a solution - no need to solve the puzzle again */
+				setSolutionCurrent();
+			}
 		}
 		else {
 			printf("Error: File cannot be opened\n");
@@ -376,7 +391,6 @@ unsigned int executeSet(int row, int col, int val) {
 		if(lastVal != (unsigned int)val) {
 			/* update cell value and erroneous values */
 			setCellVal(&gameBoard, row, col, val);
-			updateErroneous(&gameBoard, row, col, lastVal);
 			/* Add move to list (for undo/redo) */
 			move = createNewSinglyLinkedList();
 			singly_addLast(move,row,col,val,lastVal);
@@ -428,12 +442,13 @@ unsigned int executeValidate() {
 /*
  * Available in EDIT mode only.
  * If the arguments are valid (as described below):
- * Generates a puzzle by randomly filling X cells with random legal values,
- * running ILP to solve the resulting board, and then clearing all but Y random cells.
+ * Generates a puzzle by building a random solved board - a valid pattern shuffled by the changes that keep
+ * a board solved (see generate() in Solver.h) - and then clearing all but Y random cells.
+ * X is ignored once it is in range: filling X random cells and solving the board would also end with a random solved board.
  * Finally prints the board.
  * returns TRUE iff the game mode is EDIT.
  *
- * int	X	-	Number of random legal values (between 0 and N*N if valid).
+ * int	X	-	Number of random legal values (between 0 and N*N if valid) - ignored.
  * int	Y	-	Number of cells to display on the board (between 0 and N*N if valid).
  *
  */
@@ -507,6 +522,7 @@ unsigned int executeRedo() {
  * Available in EDIT and SOLVE modes.
  * If given a valid path, saves the current game board to the given path address.
  * In EDIT mode, saves only if the board does not contain erroneous values and the board is solvable, else - prints an error message.
+ * Paths with the extension BINARY_EXTENSION (see FileManager.h) are saved in the binary format.
  * Otherwise (invalid path), prints an error message.
  * returns TRUE iff the game mode is SOLVE or EDIT and string path is not empty (a path was given by the player).
  *
@@ -514,8 +530,8 @@ unsigned int executeRedo() {
  */
 unsigned int executeSave(char* path) {
 	unsigned int gameMode = getGameMode();
-	unsigned int solvable;
-	unsigned int saveSuccessful;
+	int solvable = FALSE;
+	int saveSuccessful;
 	if(gameMode == INIT) return FALSE;
 	if(path[0] == '\0') { /* no path given */
 		return FALSE;
@@ -534,8 +550,14 @@ unsigned int executeSave(char* path) {
 			return TRUE;
 		}
 	}
-	/* try to save the puzzle to the given path, and print message indicating the success or failure */
-	saveSuccessful = saveBoard(gameBoard, path, gameMode);
+	/* try to save the puzzle to the given path, and print message indicating the success or failure.
+	 * Paths with the binary extension are saved in the binary format - in edit mode, with the solution found by the validation. */
+	if(isBinaryPath(path)) {
+		saveSuccessful = saveBinaryBoard(&gameBoard, (gameMode == EDIT && solvable == TRUE) ? &solutionBoard : NULL, path, gameMode);
+	}
+	else {
+		saveSuccessful = saveBoard(gameBoard, path, gameMode);
+	}
 	if(saveSuccessful == TRUE) {
 		printf("Saved to: %s\n", path);
 	}
@@ -593,8 +615,8 @@ unsigned int executeHint(int row, int col) {
 		return TRUE;
 	}
 
-	/* try to solve with ILP */
-	isSolvable = ilpSolve(&gameBoard, &solutionBoard);
+	/* try to solve (propagation first, then the solving method if needed). updates solutionBoard if solvable. */
+	isSolvable = validate(&gameBoard);
 	if(isSolvable == -1) { /* Gurobi failure */
 		printf("Error: Gurobi failure. Please try again\n");
 	}
@@ -612,22 +634,40 @@ unsigned int executeHint(int row, int col) {
  * Available in EDIT and SOLVE modes.
  * Prints the number of solutions for the current board, but only if the board does not contain erroneous values,
  * Otherwise, an error message is printed.
+ * If a limit is given, the counting stops after limit solutions. A limit of 1 is raised to 2 - the least limit
+ * that tells a good board (a single solution) from a board with more solutions.
  * returns TRUE iff the game mode is EDIT or SOLVE.
+ *
+ * int	limit	-	The maximal number of solutions to count (NO_LIMIT to count all of them, INVALID if not a valid number).
  */
-unsigned int executeNumSolutions() {
+unsigned int executeNumSolutions(int limit) {
 	unsigned int	n; /* number of solutions */
+	unsigned int	reachedLimit;
 	Board*			boardPtr = &gameBoard;
 	if(getGameMode() == INIT) return FALSE;
+	if(limit == INVALID) {
+		printf("Error: the limit should be a non-negative integer\n");
+		return TRUE;
+	}
 	/* check if there are erroneous cells*/
 	if (hasErrors(boardPtr)){
 		printf("Error: board contains erroneous values\n");
 		return TRUE;
 	}
-	/* Calculate the number of solutions using exhaustive backtracking (implemented using a stack) */
-	n = numSolutions(boardPtr);
+	if(limit == 1) { /* counting a second solution is needed for the verdict */
+		limit = 2;
+	}
+	/* Calculate the number of solutions (stop after limit solutions) */
+	n = countSolutions(boardPtr, limit);
+	reachedLimit = (limit != NO_LIMIT && n >= (unsigned int)limit);
 	/* print results */
-	printf("Number of solutions: %d\n",n);
-	if(n == 1) {
+	if(reachedLimit) {
+		printf("Number of solutions: at least %d\n",n);
+	}
+	else {
+		printf("Number of solutions: %d\n",n);
+	}
+	if(n == 1 && !reachedLimit) {
 		printf("This is a good board!\n");
 	}
 	else if(n > 1) {
@@ -680,7 +720,7 @@ unsigned int executeReset() {
 
 /*
  * Available in all game modes.
- * Frees all memory resources.
+ * Frees all memory resources (and the Gurobi environment).
  * This method is followed by a termination of the program in the main module.
  * returns TRUE - always.
  */
@@ -690,6 +730,26 @@ unsigned int executeExit() {
 	freeBoard(gameBoardPtr);
 	freeBoard(solBoardPtr);
 	clearMoveList();
+	ilpFreeEnv();
+	return TRUE;
+}
+
+
+/*
+ * Available in all game modes.
+ * Selects the solver backend with the given name (see selectSolverBackend() in Solver.h) - it is used by the
+ * validate, hint and save commands if it can solve boards, and by num_solutions if it can count solutions.
+ * If no name was given - prints the backends in use. If there is no backend with the given name - prints an error message.
+ * returns TRUE - always.
+ *
+ * char*	name	-	The name of the backend (an empty string if not provided).
+ */
+unsigned int executeSolver(char* name) {
+	if(name[0] != '\0' && !selectSolverBackend(name)) {
+		printf("Error: unknown solver, the solvers are backtracking, dlx, ilp and kernels\n");
+		return TRUE;
+	}
+	printf("Solver: %s (counting: %s)\n", getBackendName(getSolvingMethod()), getBackendName(getCountingMethod()));
 	return TRUE;
 }
 
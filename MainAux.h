@@ -9,6 +9,6 @@
  * returns TRUE iff command executed successfully.
  *
  * unsigned int*	command		-	The already encoded user command (after interpretation).
- * char*			path		-	An file path (used by edit, solve, and save commands).
+ * char*			path		-	An file path (used by edit, solve, and save commands), or a backend name (used by the solver command).
  */
 unsigned int	executeCommand (int*, char*);
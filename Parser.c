@@ -19,6 +19,7 @@
 #include <string.h>
 #include "Parser.h"
 #include "Game.h"
+#include "Solver.h" /* import NO_LIMIT */
 
 
 
@@ -126,6 +127,7 @@ int toInt(char* str) {
  * 		13 - autofill
  * 		14 - reset
  * 		15 - exit
+ * 		16 - solver
  *
  *	 if command[0] == 1 (solve):
  * 		path	   = the path and filename to load the puzzle from.
@@ -142,7 +144,7 @@ int toInt(char* str) {
  * 		command[3] = value (0-N).
  *
  * 	 if command[0] == 7 (generate):
- * 		command[1] = X, number of random legal values (0-N*N).
+ * 		command[1] = X, number of random legal values (0-N*N) - range-checked only, it doesn't change the puzzle.
  * 		command[2] = Y, number of cells to display on the board (0-N*N).
  *
  * 	 if command[0] == 10 (save):
@@ -152,12 +154,18 @@ int toInt(char* str) {
  * 		command[1] = column number (1-N).
  * 		command[2] = row number (1-N).
  *
+ *	 if command[0] == 12 (num_solutions):
+ * 		command[1] = the maximal number of solutions to count (NO_LIMIT if not provided).
+ *
+ *	 if command[0] == 16 (solver):
+ * 		path	   = the name of the solver backend to select (optional, if provided).
+ *
  *
  * returns TRUE iff a valid command (i.e. the number of arguments given by the player is valid, regardless of the game mode).
  *
  * char*			input		-	User input.
  * unsigned int*	command		-	The encoded command will be stored on this array.
- * char*			path		-	Used only by the solve, edit, and save commands. Assumes memory allocated already, will store a path to load form/save to.
+ * char*			path		-	Used only by the solve, edit, save and solver commands. Assumes memory allocated already, will store a path to load form/save to (or a backend name).
  */
 unsigned int interpretCommand (char* input, int* command, char* path) {
 	int 	i1,i2,i3;
@@ -256,6 +264,8 @@ unsigned int interpretCommand (char* input, int* command, char* path) {
 	}
 	else if (stringsEqual(strArr[0],"num_solutions")) {
 		command[0] = 12;
+		/* optional limit - stop counting after this many solutions (0 or none for no limit) */
+		command[1] = (strArr[1] == NULL) ? NO_LIMIT : i1;
 	}
 	else if (stringsEqual(strArr[0],"autofill")) {
 		command[0] = 13;
@@ -266,6 +276,13 @@ unsigned int interpretCommand (char* input, int* command, char* path) {
 	else if (stringsEqual(strArr[0],"exit")) {
 		command[0] = 15;
 	}
+	else if (stringsEqual(strArr[0],"solver")) {
+		command[0] = 16;
+		/* Copy given backend name to the string path */
+		if(strArr[1] != NULL) {
+			strcpy(path,strArr[1]);
+		}
+	}
 	else {
 		isValidCommand = FALSE;
 	}
@@ -52,6 +52,7 @@ int				toInt(char*);
  * 		13 - autofill
  * 		14 - reset
  * 		15 - exit
+ * 		16 - solver
  *
  *	 if command[0] == 1 (solve):
  * 		path	   = the path and filename to load the puzzle from.
@@ -68,7 +69,7 @@ int				toInt(char*);
  * 		command[3] = value (0-N).
  *
  * 	 if command[0] == 7 (generate):
- * 		command[1] = X, number of random legal values (0-N*N).
+ * 		command[1] = X, number of random legal values (0-N*N) - range-checked only, it doesn't change the puzzle.
  * 		command[2] = Y, number of cells to display on the board (0-N*N).
  *
  * 	 if command[0] == 10 (save):
@@ -78,11 +79,17 @@ int				toInt(char*);
  * 		command[1] = column number (1-N).
  * 		command[2] = row number (1-N).
  *
+ *	 if command[0] == 12 (num_solutions):
+ * 		command[1] = the maximal number of solutions to count (NO_LIMIT if not provided).
+ *
+ *	 if command[0] == 16 (solver):
+ * 		path	   = the name of the solver backend to select (optional, if provided).
+ *
  *
  * returns TRUE iff valid command.
  *
  * char*			input		-	User input.
  * unsigned int*	command		-	The encoded command will be stored on this array.
- * char*			path		-	Used only by the solve, edit, and save commands. Assumes memory allocated already, will store a path to load form/save to.
+ * char*			path		-	Used only by the solve, edit, save and solver commands. Assumes memory allocated already, will store a path to load form/save to (or a backend name).
  */
 unsigned int	interpretCommand (char* , int*, char*);
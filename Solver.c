@@ -3,45 +3,146 @@
  *  It includes validating a board, auto-fill a board, check number of solution etc.
  *
  * A. Private functions
- * 	1. possibleVals() 			:	Calculate all the legal values for cell[row,col], and update the "possible" array.
- * 	2. chooseRandVal()			:	Randomly chooses and returns a value from all possible values.
+ * 	1. possibleVals() 			:	Calculate all the legal values for cell[row,col], and update the "possible" set.
+ * 	2. randomPermutation()		:	Fills an array with a random permutation of 0,...,size-1.
  * 	3. calcNextCell()  			:	Given the coordinates of a cell (row and column), calculates the coordinates of the next cell
- * 	4. getNextCellCordinates()	:	used for numSolutions - Calculates the next cell to be checked
+ * 	4. getNextCellCordinates()	:	used for numSolutions - Calculates the next cell to be checked (row-major or MRV order)
  * 	5. initCell()      			:	used for numSolutions - init default cell settings for every new cell we check
- * 	6. exhaustiveBacktracking()	:	used for numSolutions - Exhaustive backtracking on the board, and returns num of solutions
+ * 	6. updateQueuedPeers()		:	used for numSolutions - Updates the number of possible values of the empty cells that
+ * 									share a row, column or block with a cell that has changed
+ * 	7. dequeueCells()			:	used for numSolutions - Takes cells that were assigned values out of the MRV queue
+ * 	8. requeueCells()			:	used for numSolutions - Puts cells that were cleared back in the MRV queue
+ * 	9. exhaustiveBacktracking()	:	used for numSolutions - Exhaustive backtracking on the board, and returns num of solutions
+ * 	10. initPropagation()		:	Allocates the scratch space used by the propagation engine.
+ * 	11. freePropagation()		:	Frees the scratch space used by the propagation engine.
+ * 	12. getUnitCell()			:	Calculates the coordinates of the k'th cell of a unit (row, column or block).
+ * 	13. getUnitUsed()			:	Returns the set of values used by a unit.
+ * 	14. assignCandidate()		:	Assigns a value to a cell during the propagation, and removes it from the candidates of its peers.
+ * 	15. removeCandidates()		:	Removes a set of values from the candidates of a cell.
+ * 	16. nakedSingles()			:	Assigns every empty cell which has a single candidate.
+ * 	17. hiddenSingles()			:	Assigns every value which has a single possible cell in a unit.
+ * 	18. lockedCandidates()		:	Eliminates candidates using the intersections of lines and blocks (pointing / claiming).
+ * 	19. propagate()				:	Applies the rules above repeatedly, until none of them changes the board (a fixpoint).
+ * 	20. undoPropagation()		:	Clears the cells assigned by the propagation since a given point of the trail.
+ * 	21. sequentialCount()		:	Counts the solutions of a propagated board on the calling thread, using the counting method.
+ * 	22. saveValues()			:	Returns a copy of the values of a board's cells (a task of the parallel counting).
+ * 	23. loadValues()			:	Sets a board to contain exactly the values of a task.
+ * 	24. splitSearch()			:	Splits the search tree of a board into subtrees (tasks) at shallow depth.
+ * 	25. countTask()				:	Counts the solutions of a single task, on a worker thread.
+ * 	26. parallelCount()			:	Counts the solutions of a board with a work-stealing pool of threads.
+ * 	27. backtrackingSolve()		:	The solve operation of the backtracking backend.
+ * 	28. backtrackingCount()		:	The count operation of the backtracking backend.
+ * 	29. kernelsCount()			:	The count operation of the kernels backend.
+ * 	30. fillRandomGrid()		:	used for generate - Fills an empty board with a random solved board.
  *
  * B. Public functions:
  * 	1.validate() 				:	Checks if the current configuration of the game board is solvable
  * 	2.isBoardComplete()			:	Returns TRUE if all cells are filled on a game board and are not erroneous.
  * 	3.autofill() 				:	Fill cells which contain exactly a single legal value
  * 	4.numSolutions ()   		:	Calculates the number of solutions for the current board.
- * 	5.generate() 				:	Try to generate x cells at gameBoardPtr board.
- * 						   			try to solve with ilp(result at "solution_board" so we copy it to gameBoardPtr board).
- *		 						  	finally deleting cells values until only y values left.
+ * 	5.generate() 				:	Generates a puzzle - fills gameBoardPtr board with a random solved board,
+ *		 						  	then deletes cells values until only y values left.
+ * 	6.setCountingMethod()		:	Sets the method used by numSolutions().
+ * 	7.getCountingMethod()		:	Returns the method used by numSolutions().
+ * 	8.countSolutions()			:	Calculates the number of solutions for the current board, up to a given limit.
+ * 	9.setNumThreads()			:	Sets the number of threads used for counting solutions.
+ * 	10.getNumThreads()			:	Returns the number of threads used for counting solutions.
+ * 	11.setSolvingMethod()		:	Sets the method used by validate() for solving boards.
+ * 	12.getSolvingMethod()		:	Returns the method used by validate() for solving boards.
+ * 	13.solveBoard()				:	Solves a board with the solving method, and updates its solution board.
+ * 	14.selectSolverBackend()	:	Selects the solving (and counting) method by the name of its backend.
+ * 	15.getBackendName()			:	Returns the name of the backend of a method.
  *
  */
 
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "Solver.h"
 #include "Stack.h"
+#include "BucketQueue.h"
 #include "ILP_Solver.h"
+#include "DLX.h"
+#include "ThreadPool.h"
+#include "Kernels.h"
 #define	TRUE	1
 #define FALSE	0
 
+/* Cell selection policies of the exhaustive backtracking */
+#define ROW_MAJOR_ORDER		0	/* left to right, top to bottom */
+#define MRV_ORDER			1	/* minimum remaining values - the cell with the least possible values first */
+
+/*
+ * Scratch space of the propagation engine (see propagate()).
+ * The candidates of the cells are recomputed from the used values of the board at every call, and are then
+ * narrowed by the elimination rules. The cells assigned by the propagation are recorded in the trail, so they can be undone.
+ */
+typedef struct propagation_t {
+	Candidates*		cands;		/* cands[row*N+col] - the candidates of cell[row][col] (empty set if the cell is filled) */
+	unsigned int*	units;		/* units[unit*N+k] - the k'th cell (row*N+col) of each unit (see getUnitCell()) */
+	unsigned int*	trail;		/* the cells (row*N+col) assigned by the propagation, in order of assignment */
+	unsigned int	trailSize;
+} Propagation;
+
+/* Parallel counting */
+#define PARALLEL_MIN_EMPTY_CELLS	40	/* boards with less empty cells are counted faster by a single thread */
+#define TASKS_PER_THREAD			16	/* the search is split into about this many subtrees per thread */
+
+/* Shared data of the workers of the parallel counting (see parallelCount()) */
+typedef struct parallel_count_t {
+	Board*			boards;		/* boards[i] - the board of worker i */
+	unsigned int*	counters;	/* counters[i] - the number of solutions counted by worker i */
+} ParallelCount;
+
+unsigned int	countingMethod = KERNELS;		/* the method used by numSolutions() */
+unsigned int	solvingMethod = DANCING_LINKS;	/* the method used by validate() */
+unsigned int	numThreads = 0;					/* threads used for counting solutions (0 - one per processor) */
+
 /********** Private method declarations **********/
 /* Includes *some* of the private methods in this module */
 
-void possibleVals(Board* boardPtr, unsigned int row, unsigned int col, unsigned int* possible);
-unsigned int chooseRandVal(unsigned int* possible, unsigned int posValsCount);
+unsigned int possibleVals(Board* boardPtr, unsigned int row, unsigned int col, Candidates* possible);
+void randomPermutation(unsigned int* perm, unsigned int size);
 void calcNextCell(unsigned int N, unsigned int row, unsigned int col, unsigned int* nextRow, unsigned int* nextCol);
-void getNextCellCordinates(info** cd, unsigned int N);
-void initCell (Board* original, Board* temp, info** def, unsigned int N);
-int exhaustiveBacktracking(Board* original, Board* temp);
+unsigned int getNextCellCordinates(Board* temp, BucketQueue* queue, unsigned int order, info* cd);
+void initCell (Board* temp, info* def);
+void updateQueuedPeers(Board* temp, BucketQueue* queue, unsigned int row, unsigned int col);
+void dequeueCells(Board* temp, BucketQueue* queue, unsigned int* cells, unsigned int from, unsigned int to);
+void requeueCells(Board* temp, BucketQueue* queue, unsigned int* cells, unsigned int from, unsigned int to);
+unsigned int exhaustiveBacktracking(Board* temp, unsigned int order, unsigned int limit);
+void initPropagation(Propagation* prop, Board* boardPtr);
+void freePropagation(Propagation* prop);
+void getUnitCell(Board* boardPtr, unsigned int unit, unsigned int k, unsigned int* row, unsigned int* col);
+Candidates* getUnitUsed(Board* boardPtr, unsigned int unit);
+void assignCandidate(Board* boardPtr, Propagation* prop, unsigned int row, unsigned int col, unsigned int val);
+unsigned int removeCandidates(Propagation* prop, unsigned int cell, Candidates* values);
+int nakedSingles(Board* boardPtr, Propagation* prop);
+int hiddenSingles(Board* boardPtr, Propagation* prop);
+int lockedCandidates(Board* boardPtr, Propagation* prop);
+unsigned int propagate(Board* boardPtr, Propagation* prop);
+void undoPropagation(Board* boardPtr, Propagation* prop, unsigned int mark);
+unsigned int sequentialCount(Board* temp, unsigned int limit);
+unsigned char* saveValues(Board* boardPtr);
+void loadValues(Board* boardPtr, unsigned char* values);
+unsigned char** splitSearch(Board* temp, unsigned int target, unsigned int* numTasks, unsigned int* counter);
+void countTask(void* task, unsigned int worker, void* context);
+unsigned int parallelCount(Board* temp, unsigned int numWorkers);
+int backtrackingSolve(Board* boardPtr, Board* solBoardPtr);
+unsigned int backtrackingCount(Board* temp, unsigned int limit);
+unsigned int kernelsCount(Board* temp, unsigned int limit);
+void fillRandomGrid(Board* boardPtr);
 
 /******* End of private method declarations ******/
 
+/* The solver backends, indexed by their method (see SolverBackend in Solver.h) */
+SolverBackend	backends[NUM_BACKENDS] = {
+	{ "backtracking",	backtrackingSolve,	backtrackingCount,	NULL },			/* BACKTRACKING */
+	{ "dlx",			dlxSolve,			dlxNumSolutions,	NULL },			/* DANCING_LINKS */
+	{ "ilp",			ilpSolve,			NULL,				ilpSolveGame },	/* ILP */
+	{ "kernels",		NULL,				kernelsCount,		NULL }			/* KERNELS */
+};
+
 
 
 /************************* Public methods *************************/
@@ -50,14 +151,52 @@ int exhaustiveBacktracking(Board* original, Board* temp);
 /*
  * Checks if the current configuration of the game board is solvable.
  * If solvable and some cells' val field != sol_val - update relevant sol_val's.
- * Returns TRUE iff current configuration of game board is solvable.
+ * Returns TRUE iff current configuration of game board is solvable (-1 on Gurobi failure).
+ * The board is propagated first - the method set by setSolvingMethod() (dancing links by default) is used only
+ * if the propagation neither solves the board nor finds a contradiction.
+ * The backend of the method solves the board with its solveGame() operation, if it has one (see SolverBackend).
+ * The solution of the game board is cached - it is not solved again while the last solution still fits it (see isSolutionCurrent()).
  *
  *	Pre: board is not erroneous	(Checked in MainAux.c)
  *
  * Board*	boardPtr		-	A pointer a game board.
  */
 int validate(Board* boardPtr) {
-	unsigned int isSolvable = ilpSolve(boardPtr,getSolutionBoardPtr()); /* try to solve the board and update the sol board if solvable. */
+	Board 			tempBoard = {'\0'};
+	Propagation		prop;
+	unsigned int	m = boardPtr->m, n = boardPtr->n;
+	unsigned int	N = m*n;
+	int				isSolvable;
+
+	if(boardPtr == getGameBoardPtr() && isSolutionCurrent()) { /* the solution found last time still fits the board */
+		return TRUE;
+	}
+
+	/* prepare temp board - the propagation assigns values to a copy of the board */
+	initializeBoard(&tempBoard, m, n);
+	copyBoard(boardPtr, &tempBoard);
+	initPropagation(&prop, &tempBoard);
+
+	if(!propagate(&tempBoard, &prop)) {				/* contradiction - no solution */
+		isSolvable = FALSE;
+	}
+	else if(tempBoard.cellsDisplayed == N*N) {		/* solved by propagation alone */
+		copyBoard(&tempBoard, getSolutionBoardPtr());
+		isSolvable = TRUE;
+	}
+	else if(backends[solvingMethod].solveGame != NULL) { /* the backend keeps its state between the calls */
+		isSolvable = backends[solvingMethod].solveGame(&tempBoard, getSolutionBoardPtr());
+	}
+	else { /* try to solve the rest of the board and update the sol board if solvable. */
+		isSolvable = solveBoard(&tempBoard, getSolutionBoardPtr());
+	}
+
+	if(boardPtr == getGameBoardPtr() && isSolvable == TRUE) { /* cache the solution of the game (see isSolutionCurrent()) */
+		setSolutionCurrent();
+	}
+
+	freePropagation(&prop);
+	freeBoard(&tempBoard);
 	return isSolvable;
 }
 
@@ -89,19 +228,12 @@ void autofill(Board* boardPtr){
 	unsigned int		m = boardPtr->m, n = boardPtr->n;
 	unsigned int 		N = m*n;
 	unsigned int 		row , col, val;
-	unsigned int* 		possible;
+	Candidates			possible;
 	unsigned int		posValsCount;
 	unsigned int		lastVal;
 	Cell* 				cell;
 	SinglyLinkedList*	move;
 
-	/* allocate array of possibilities */
-	possible = (unsigned int*)calloc(N+1, sizeof(unsigned int));
-	if(possible == NULL) {
-		printf("Error: calloc has failed\n");
-		exit(1);
-	}
-
 	/* copy:
 	 * all the suggested values by autofill
 	 * are the values which already on the board:*/
@@ -115,20 +247,15 @@ void autofill(Board* boardPtr){
 			cell = getCell(&constBoard,row,col);
 			if (cell->value!=0)continue; /*cell is not empty-->continue*/
 			/* Calculate all the possible values for current cell, and save in possible:*/
-			possibleVals(&constBoard,row,col,possible);
-			posValsCount = possible[N];  /*Number of possible values*/
+			posValsCount = possibleVals(&constBoard,row,col,&possible);  /*Number of possible values*/
 			/* if there are a few choices- ignore this cell:*/
 			if(posValsCount != 1)continue;
-			/*there is only one choice-->find it*/
-			for(val=0; val<N; val++){
-				if(possible[val]){
-					printf("Cell <%d,%d> set to %d\n",col+1,row+1,val+1);
-					lastVal = cell->value;
-					setCellVal(boardPtr,row,col,val+1);
-					singly_addLast(move,row,col,val+1,lastVal);
-					break;
-				}
-			}
+			/*there is only one choice-->it is the smallest (and only) value in possible*/
+			val = cand_next(&possible,0);
+			printf("Cell <%d,%d> set to %d\n",col+1,row+1,val);
+			lastVal = cell->value;
+			setCellVal(boardPtr,row,col,val);
+			singly_addLast(move,row,col,val,lastVal);
 		}
 	}
 
@@ -140,7 +267,6 @@ void autofill(Board* boardPtr){
 		singly_clear(move);
 	}
 
-	free(possible);
 	freeBoard(&constBoard);
 
 	return;
@@ -148,94 +274,81 @@ void autofill(Board* boardPtr){
 
 
 /*
- * Calculates the number of solutions for the current board
+ * Calculates the number of solutions for the current board,
+ * using the method set by setCountingMethod() (the geometry kernels by default).
  *
  * Board*	boardPtr		-	A pointer a game board.
  */
 unsigned int numSolutions(Board* boardPtr){
+	return countSolutions(boardPtr, NO_LIMIT);
+}
+
+
+/*
+ * Calculates the number of solutions for the current board, using the method set by setCountingMethod().
+ * Stops counting once limit solutions were found, and returns limit - so a limit of 2 is enough
+ * to tell an unsolvable board (0), a board with a unique solution (1) and a board with more than one solution (2).
+ *
+ * Board*			boardPtr	-	A pointer a game board.
+ * unsigned int		limit		-	The maximal number of solutions to count (NO_LIMIT to count all of them).
+ */
+unsigned int countSolutions(Board* boardPtr, unsigned int limit){
 	unsigned int	 counter = 0;
+	unsigned int	 N = boardPtr->m * boardPtr->n;
+	unsigned int	 numWorkers = (numThreads == 0) ? tp_numCores() : numThreads;
 	Board 			 tempBoard = {'\0'};
+	Propagation		 prop;
 	/* prepare temp board -
 	 * This board will be a copy of board, and will be solved instead of it.*/
 	initializeBoard(&tempBoard, boardPtr->m, boardPtr->n);
 	copyBoard(boardPtr, &tempBoard);
-	/* try to solve the board */
-	counter =  exhaustiveBacktracking (boardPtr, &tempBoard);
+	initPropagation(&prop, &tempBoard);
+	/* assign all the forced values first - they are common to all solutions */
+	if(!propagate(&tempBoard, &prop)) {
+		counter = 0;
+	}
+	else if(limit == NO_LIMIT && numWorkers > 1 && N*N - tempBoard.cellsDisplayed >= PARALLEL_MIN_EMPTY_CELLS) {
+		counter = parallelCount(&tempBoard, numWorkers);
+	}
+	else { /* try to solve the board */
+		counter = sequentialCount(&tempBoard, limit);
+	}
 	/* Free allocated temporary board */
+	freePropagation(&prop);
 	freeBoard(&tempBoard);
 	return counter;
 }
 
 
 /*
- * Try to generate x cells at gameBoardPtr board.
- * try to solve with ilp(result at "solution_board" so we copy it to gameBoardPtr board).
- * finally deleting cells values until only y values left.
+ * Generates a puzzle at gameBoardPtr board: fills it with a random solved board (see fillRandomGrid()),
+ * which is also kept as the solution of the game, then deletes cells values until only y values left.
+ * The solved board is built directly, without a solver - the time is O(N^2).
+ * x is ignored: filling x random cells with random legal values and solving the board (the definition of the command)
+ * ends with a random solved board as well.
+ * Returns TRUE (a solved board always exists).
  *
  * pre: we are in EDIT mode			(Checked in MainAux.c)
+ * pre: the board is empty			(Checked in MainAux.c)
  * pre: x, y to are int 			(Checked in MainAux.c)
  * pre :x, y have legal coordinates (Checked in MainAux.c)
  */
 unsigned int generate(Board* gameBoardPtr,int x, int y ) {
 	SinglyLinkedList*	move;
-	unsigned int	x_values_successfully, ilpSuccessful;
-	unsigned int	rand_row, rand_col, rand_val, posValsCount;
+	unsigned int	rand_row, rand_col;
 	unsigned int	m = gameBoardPtr->m, n = gameBoardPtr->n;
 	int	N = m*n;
-	int i,j,try;
+	int i,j;
 	Cell* cur_cell;
 
-	/* try 1000 times(max) to fill x cells */
-	for(try = 0; try < 1000; try++){
-		x_values_successfully = TRUE;
-		ilpSuccessful = FALSE;
-		for (i=0; i<x; i++){ /* find x good values */
-			/* choose random cell */
-			rand_col = rand()%N;
-			rand_row = rand()%N;
-			cur_cell = getCell(gameBoardPtr, rand_row, rand_col);
-			/* if cell already has value-> choose another cell instead */
-			if(cur_cell->value != 0){
-				i--;
-				continue;
-			}
-			/* Calculate all the possible values for current cell. */
-			possibleVals(gameBoardPtr, rand_row, rand_col, cur_cell->possible_vals);
-			posValsCount = cur_cell->possible_vals[N];		/* Number of possible values */
-			/* Choose a random value for the cell*/
-			if(posValsCount == 0){ /* Each value for this cell will be illegal */
-				nullifyBoard(gameBoardPtr);
-				x_values_successfully = FALSE;
-				break; /* next try */
-			}
-			else{/* we can fill this cell legally with a value */
-				rand_val = chooseRandVal(cur_cell->possible_vals, posValsCount);
-				setCellVal(gameBoardPtr,rand_row,rand_col,rand_val);
-			}
-		}/* finished current board building, maybe with illegal board */
-
-		if(x_values_successfully){ /* Try to solve board */
-			ilpSuccessful = ilpSolve(gameBoardPtr,getSolutionBoardPtr());
-		}
-
-		if(ilpSuccessful) break;
-		else{
-			nullifyBoard(gameBoardPtr);
-				continue;
-		}
+	(void)x; /* ignored (see above) */
 
-	}/* Outer for loop was ended */
-
-	if(!ilpSuccessful){	/* Failed to generate the board */
-		nullifyBoard(gameBoardPtr);
-	    return FALSE;
-	}
-	/* board generated successfully. */
-	/* now, copy the board that ILP solved to be our board */
-	copyBoard(getSolutionBoardPtr(), gameBoardPtr);
+	/* the solved board is the solution of the puzzle - clearing cells keeps it (see isSolutionCurrent()) */
+	fillRandomGrid(gameBoardPtr);
+	copyBoard(gameBoardPtr, getSolutionBoardPtr());
+	setSolutionCurrent();
 
 	/* keep only y cells */
-	gameBoardPtr->cellsDisplayed = N*N;
 	while(gameBoardPtr->cellsDisplayed > (unsigned int)y  ){
 		/* choose random cell */
 		rand_col = rand()%N ;
@@ -269,97 +382,156 @@ unsigned int generate(Board* gameBoardPtr,int x, int y ) {
 }
 
 
-/********************** End of public methods *********************/
+/*
+ * Sets the method used by numSolutions() for counting solutions.
+ *
+ * unsigned int	method	-	BACKTRACKING, DANCING_LINKS or KERNELS (a backend that can count).
+ */
+void setCountingMethod(unsigned int method) {
+	countingMethod = method;
+}
 
 
+/*
+ * Returns the method used by numSolutions() for counting solutions.
+ */
+unsigned int getCountingMethod() {
+	return countingMethod;
+}
 
-/************************* Private methods *************************/
 
 /*
- * Calculate all the legal values for cell[row,col], and update the "possible" array.
+ * Sets the number of threads used by numSolutions() for counting solutions.
  *
- * Board* 			board		-	A pointer to a game board.
- * unsigned int		m			-	Number of rows of cells in each block.
- * unsigned int		n			-	Number of columns of cells in each block.
- * unsigned int		row			-	Row number (between 0 and N-1).
- * unsigned int 	col			-	Column number (between 0 and N-1).
- * unsigned int* 	possible	-	A binary array indicating which values are possible to assign to this cell,
- * 									and the number of possible values at the end of the array.
+ * unsigned int	threads	-	Number of threads (1 - no parallel counting, 0 - one thread per online processor).
  */
-void possibleVals(Board* boardPtr, unsigned int row, unsigned int col, unsigned int* possible) {
-	unsigned int	i, j, count_i, count_j;
-	unsigned int	m = boardPtr->m, n = boardPtr->n;
-	unsigned int	N = m*n;
-	int				val;
-	for(i = 0; i < N; i++) {
-		possible[i] = TRUE;
-	}
-	possible[N] = 0;
+void setNumThreads(unsigned int threads) {
+	numThreads = threads;
+}
 
-	/* Row */
-	for(j = 0; j < N; j++) {
-		val = getCell(boardPtr, row,j)->value;
-		if(val > 0) {
-			possible[val-1] = FALSE;
-		}
-	}
 
+/*
+ * Returns the number of threads used by numSolutions() for counting solutions (0 - one thread per online processor).
+ */
+unsigned int getNumThreads() {
+	return numThreads;
+}
 
-	/* Column */
-	for(i = 0; i < N; i++) {
-		val = getCell(boardPtr, i, col)->value;
-		if(val > 0) {
-			possible[val-1] = FALSE;
-		}
-	}
 
-	/* Block */
-	i = m*((row)/m); /* Index of the first row of the block */
-	j = n*((col)/n); /* Index of the first column of the block */
-	for(count_i = 0; count_i < m; count_i++) {
-		for(count_j = 0; count_j < n; count_j++) {
-			val = getCell(boardPtr, i+count_i, j+count_j)->value;
-			if(val > 0) {
-				possible[val-1] = FALSE;
+/*
+ * Sets the method used by validate() for solving boards (and so by the hint, validate, generate and save commands).
+ *
+ * unsigned int	method	-	BACKTRACKING, DANCING_LINKS or ILP.
+ */
+void setSolvingMethod(unsigned int method) {
+	solvingMethod = method;
+}
+
+
+/*
+ * Returns the method used by validate() for solving boards.
+ */
+unsigned int getSolvingMethod() {
+	return solvingMethod;
+}
+
+
+/*
+ * Solves a board with the method set by setSolvingMethod(), and updates its solution board.
+ * Unlike validate(), the board is not propagated first, and the solution board of the game is not used.
+ * Returns TRUE iff the board is solvable (if not - the solution board is not changed), -1 on Gurobi failure.
+ *
+ * pre: the board has no erroneous cells
+ *
+ * Board*	boardPtr	-	A pointer to a board.
+ * Board*	solBoardPtr	-	A pointer to the solution board (of the same size).
+ */
+int solveBoard(Board* boardPtr, Board* solBoardPtr) {
+	return backends[solvingMethod].solve(boardPtr, solBoardPtr);
+}
+
+
+/*
+ * Selects the backend with a given name ("backtracking", "dlx", "ilp" or "kernels") for solving boards if it can solve,
+ * and for counting solutions if it can count (ILP can't count and the kernels can't solve - the other method is then unchanged).
+ * Returns TRUE iff there is a backend with this name.
+ *
+ * char*	name	-	The name of the backend.
+ */
+int selectSolverBackend(char* name) {
+	unsigned int	method;
+
+	for(method = 0; method < NUM_BACKENDS; method++) {
+		if(strcmp(backends[method].name, name) == 0) {
+			if(backends[method].solve != NULL) {
+				solvingMethod = method;
 			}
+			if(backends[method].count != NULL) {
+				countingMethod = method;
+			}
+			return TRUE;
 		}
 	}
+	return FALSE;
+}
 
-	/* count the number of possible values,
-	 * and put it in the last index of possible */
-	for(i = 0; i < N; i++) {
-		if(possible[i]) {
-			possible[N] ++;
-		}
-	}
+
+/*
+ * Returns the name of the backend of a solving or counting method.
+ *
+ * unsigned int	method	-	BACKTRACKING, DANCING_LINKS, ILP or KERNELS.
+ */
+char* getBackendName(unsigned int method) {
+	return backends[method].name;
 }
 
 
+/********************** End of public methods *********************/
+
+
+
+/************************* Private methods *************************/
+
 /*
- * Randomly chooses and returns a value from all possible values.
+ * Calculate all the legal values for cell[row,col], store them in the "possible" set,
+ * and return the number of legal values.
+ * Takes O(1) time, as the values used by each row, column and block are kept in the board.
  *
- * unsigned int*	possible 	-	A binary array indicating if value is possible or not, for each value from 1 to N.
- * unsigned int		posValCount	-	The number of possible values to assign on a specific cell. ie. the number of 1's in possible.
+ * Board* 			board		-	A pointer to a game board.
+ * unsigned int		row			-	Row number (between 0 and N-1).
+ * unsigned int 	col			-	Column number (between 0 and N-1).
+ * Candidates* 		possible	-	A set which will contain exactly the values that are possible to assign to this cell.
+ */
+unsigned int possibleVals(Board* boardPtr, unsigned int row, unsigned int col, Candidates* possible) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+
+	/* possible = {1,...,N} \ (values used by the row, column or block) */
+	cand_fill(possible, N);
+	cand_subtract(possible, &boardPtr->rowsUsed[row]);
+	cand_subtract(possible, &boardPtr->colsUsed[col]);
+	cand_subtract(possible, &boardPtr->blocksUsed[getBlockIndex(boardPtr, row, col)]);
+	return cand_count(possible);
+}
+
+
+/*
+ * Fills an array with a random permutation of 0,...,size-1 (Fisher-Yates shuffle).
  *
+ * unsigned int*	perm	-	An array of (at least) size elements.
+ * unsigned int		size	-	The number of elements to permute.
  */
-unsigned int chooseRandVal(unsigned int* possible, unsigned int posValsCount) {
-	unsigned int	randPos = 0;
-	unsigned int	count = 0, i = 0;
+void randomPermutation(unsigned int* perm, unsigned int size) {
+	unsigned int	i, j, tmp;
 
-	i = 0;
-	if(posValsCount > 1) { 	/* More than one possible value to choose from. Choose index randomly (between 1 and posValsCount). */
-		randPos = rand()%posValsCount + 1;
+	for(i = 0; i < size; i++) {
+		perm[i] = i;
 	}
-	else {					/* Only one possible value - no need to randomize */
-		randPos = 1;
+	for(i = size; i > 1; i--) { /* swap a random element of perm[0..i-1] to perm[i-1] */
+		j = rand()%i;
+		tmp = perm[i-1];
+		perm[i-1] = perm[j];
+		perm[j] = tmp;
 	}
-	while(count != randPos) {	/* Stop when reaching the randPos'th possible value. */
-		if(possible[i]) {	/* Found possible value */
-			count++;
-		}
-		i++;
-	}
-	return i;
 }
 
 
@@ -389,130 +561,901 @@ void calcNextCell(unsigned int N, unsigned int row, unsigned int col, unsigned i
 /****************** num_solutions() Private methods *******************/
 
 /*
- * Calculates the next cell to be checked, and
+ * Calculates the next cell to be checked - an empty cell of the temp board, chosen according to order:
+ * ROW_MAJOR_ORDER	-	the first empty cell starting from the current cell, ordered left to right, top to bottom.
+ * MRV_ORDER		-	the empty cell with the least possible values (minimum remaining values), taken out of the queue.
+ * Returns TRUE iff an empty cell was found.
  *
- * info**			cd	-	Current cell's info.
- * unsigned int 	N	-	Number of rows/columns in the board.
+ * Board* 			temp	-	A pointer a temp board.
+ * BucketQueue*		queue	-	The empty cells of the temp board, by their number of possible values (MRV_ORDER only).
+ * unsigned int		order	-	The cell selection policy.
+ * info*			cd		-	Current cell's info. Its row and column are set to the next cell.
  */
-void getNextCellCordinates(info** cd, unsigned int N){
-	unsigned int nextRow, nextCol;
-
-	/* Calculate and set next cell */
-	calcNextCell(N, (*cd)->row, (*cd)->col, &nextRow, &nextCol);
-	(*cd)->row 			= nextRow;
-	(*cd)->col 			= nextCol;
-	(*cd)->first_time 	= TRUE;
-
+unsigned int getNextCellCordinates(Board* temp, BucketQueue* queue, unsigned int order, info* cd){
+	unsigned int	N = temp->m * temp->n;
+	unsigned int	nextRow, nextCol;
+	int				cell;
+
+	if(order == MRV_ORDER) {
+		cell = bq_popMin(queue);
+		if(cell == BQ_NONE) return FALSE;
+		cd->row = cell/N;
+		cd->col = cell%N;
+		return TRUE;
+	}
+	/* ROW_MAJOR_ORDER */
+	while(cd->row < N) {
+		if(getCell(temp, cd->row, cd->col)->value == 0) return TRUE;
+		calcNextCell(N, cd->row, cd->col, &nextRow, &nextCol);
+		cd->row = nextRow;
+		cd->col = nextCol;
+	}
+	return FALSE;
 }
 
 
 /*
  * init default cell settings for every new cell we check
  *
- * Board* 			original	-	A pointer a game board.
  * Board* 			temp		-	A pointer a temp board.
- * info** 			def			-	Current cell's info.
- * unsigned int 	N			-	Number of rows/columns in the board.
+ * info* 			def			-	Current cell's info.
+ */
+void initCell (Board* temp, info* def){
+	def->val = 0; /* no value was assigned yet */
+	/* Calculate all the possible values for current cell and save in possible */
+	def->posValsCount = possibleVals(temp, def->row, def->col, &def->possible);	/* Number of possible values */
+}
+
+
+/*
+ * Updates the keys of all the queued cells in the row, column and block of cell[row][col]
+ * to their current number of possible values (after the value of cell[row][col] has changed).
+ *
+ * Board* 			temp	-	A pointer a temp board.
+ * BucketQueue*		queue	-	The empty cells of the temp board, by their number of possible values.
+ * unsigned int		row		-	Row number (between 0 and N-1).
+ * unsigned int 	col		-	Column number (between 0 and N-1).
+ */
+void updateQueuedPeers(Board* temp, BucketQueue* queue, unsigned int row, unsigned int col) {
+	unsigned int	i, j, count_i, count_j;
+	unsigned int	m = temp->m, n = temp->n;
+	unsigned int	N = m*n;
+	Candidates		possible;
+
+	/* Row */
+	for(j = 0; j < N; j++) {
+		if(bq_contains(queue, row*N+j)) {
+			bq_update(queue, row*N+j, possibleVals(temp, row, j, &possible));
+		}
+	}
+
+	/* Column */
+	for(i = 0; i < N; i++) {
+		if(bq_contains(queue, i*N+col)) {
+			bq_update(queue, i*N+col, possibleVals(temp, i, col, &possible));
+		}
+	}
+
+	/* Block */
+	i = m*((row)/m); /* Index of the first row of the block */
+	j = n*((col)/n); /* Index of the first column of the block */
+	for(count_i = 0; count_i < m; count_i++) {
+		for(count_j = 0; count_j < n; count_j++) {
+			if(i+count_i == row || j+count_j == col) continue; /* already updated */
+			if(bq_contains(queue, (i+count_i)*N + j+count_j)) {
+				bq_update(queue, (i+count_i)*N + j+count_j, possibleVals(temp, i+count_i, j+count_j, &possible));
+			}
+		}
+	}
+}
+
+
+/*
+ * Takes cells that were assigned values out of the queue (cells[from] to cells[to-1]),
+ * and updates the keys of their peers.
+ *
+ * Board* 			temp	-	A pointer a temp board.
+ * BucketQueue*		queue	-	The empty cells of the temp board, by their number of possible values.
+ * unsigned int*	cells	-	The cells (row*N+col).
+ * unsigned int		from	-	Index of the first cell.
+ * unsigned int		to		-	Index after the last cell.
  */
-void initCell (Board* original, Board* temp, info** def, unsigned int N){
-	/* Allocate memory for possible values.
-	 * we free this memory at the while loop */
-	(*def)->possible  = (unsigned int*)calloc(N+1, sizeof(unsigned int));
-	if((*def)->possible == NULL)  {printf("Error: calloc has failed\n");exit(1);}
+void dequeueCells(Board* temp, BucketQueue* queue, unsigned int* cells, unsigned int from, unsigned int to) {
+	unsigned int	N = temp->m * temp->n;
+	unsigned int	i;
 
-	/* Adjustments*/
-	(*def)->k			 = 0;
-	(*def)->counter 	 = 0;
-	(*def)->orig_cell 	 = getCell(original, (*def)->row, (*def)->col);
-	(*def)->sug_cell     = getCell(temp    , (*def)->row, (*def)->col);
+	for(i = from; i < to; i++) {
+		bq_remove(queue, cells[i]);
+	}
+	for(i = from; i < to; i++) {
+		updateQueuedPeers(temp, queue, cells[i]/N, cells[i]%N);
+	}
+}
+
+
+/*
+ * Puts cells that were cleared back in the queue (cells[from] to cells[to-1]),
+ * and updates the keys of their peers.
+ *
+ * Board* 			temp	-	A pointer a temp board.
+ * BucketQueue*		queue	-	The empty cells of the temp board, by their number of possible values.
+ * unsigned int*	cells	-	The cells (row*N+col).
+ * unsigned int		from	-	Index of the first cell.
+ * unsigned int		to		-	Index after the last cell.
+ */
+void requeueCells(Board* temp, BucketQueue* queue, unsigned int* cells, unsigned int from, unsigned int to) {
+	unsigned int	N = temp->m * temp->n;
+	unsigned int	i;
+	Candidates		possible;
 
-	possibleVals(temp, (*def)->row, (*def)->col, (*def)->possible);	/* Calculate all the possible values for current cell and save in possible */
-	(*def)->posValsCount = (*def)->possible[N];					    /* Number of possible values */
-	if((*def)->orig_cell->value !=0 ) {(*def)->posValsCount = 1;}   /* fixed cell has only 1 legal value */
+	for(i = from; i < to; i++) {
+		bq_insert(queue, cells[i], possibleVals(temp, cells[i]/N, cells[i]%N, &possible));
+	}
+	for(i = from; i < to; i++) {
+		updateQueuedPeers(temp, queue, cells[i]/N, cells[i]%N);
+	}
 }
 
 
 /*
  * Exhaustive backtracking on the board, and returns num of solutions.
+ * Only the empty cells are visited, in the order given by the cell selection policy.
+ * After each value is tried, the board is propagated (see propagate()), so forced cells are assigned
+ * without branching, and dead ends are detected as early as possible.
  *
- * Board* 			original	-	A pointer a game board.
- * Board* 			temp		-	A pointer a temp board.
+ * Stops once limit solutions were found (if limit > 0) - the temp board then holds the last solution found.
+ *
+ * pre: temp does not contain erroneous values.
+ *
+ * Board* 			temp		-	A pointer a temp board (a copy of the game board).
+ * unsigned int		order		-	The cell selection policy (ROW_MAJOR_ORDER or MRV_ORDER).
+ * unsigned int		limit		-	The maximal number of solutions to count (NO_LIMIT to count all of them).
  */
-int exhaustiveBacktracking(Board* original, Board* temp) {
+unsigned int exhaustiveBacktracking(Board* temp, unsigned int order, unsigned int limit) {
 	/* Variables */
-	unsigned int	  N         = (original->m * original->n);
-	struct StackNode* root 		= NULL;		/* beautiful stack who mimic recursion */
-	info* cd = NULL; 						/* data of current cell */
-	unsigned int counter;
+	unsigned int	  N         = (temp->m * temp->n);
+	Stack			  stack;				/* beautiful stack who mimic recursion */
+	info* cd = NULL; 						/* data of current cell (the top of the stack) */
+	info* father;
+	BucketQueue		queue;					/* empty cells by number of possible values (MRV_ORDER only) */
+	BucketQueue*	queuePtr = NULL;
+	Propagation		prop;
+	Candidates		possible;
+	unsigned int	counter = 0;
+	unsigned int	row, col, trailEnd, isConsistent;
+
+	if(temp->cellsDisplayed == N*N) { /* no empty cells - the board itself is the only solution */
+		return 1;
+	}
 
+	initStack(&stack, N*N - temp->cellsDisplayed);  /* a frame for each empty cell at most (freed after while loop) */
+	initPropagation(&prop, temp);
 
-	cd 	= (info*) malloc(sizeof(info));  /* allocate memory safely (freed after while loop) */
-	if(cd == NULL) {printf("Error: malloc has failed\n");exit(1);}
+	if(order == MRV_ORDER) {
+		bq_init(&queue, N*N, N);
+		for(row = 0; row < N; row++) {
+			for(col = 0; col < N; col++) {
+				if(getCell(temp,row,col)->value == 0) {
+					bq_insert(&queue, row*N+col, possibleVals(temp,row,col,&possible));
+				}
+			}
+		}
+		queuePtr = &queue;
+	}
 
 	/* ---adjust 1st cell data --- */
+	cd = push(&stack);
 	cd->row	= 0;cd->col	= 0;
-	cd->first_time	= TRUE;
+	getNextCellCordinates(temp, queuePtr, order, cd);
+	initCell(temp, cd);
 	/*--For each cell:--*/
-	do {
-			if(cd->first_time){  /* first time we meet a cell-->init cell */
-				initCell (original,temp, &cd, N);
+	while(TRUE) {
+		if(cd->val != 0) { /* undo the last value tried for this cell, and the values it forced */
+			trailEnd = prop.trailSize;
+			undoPropagation(temp, &prop, cd->trailMark);
+			if(queuePtr != NULL) requeueCells(temp, queuePtr, prop.trail, cd->trailMark, trailEnd);
+			placeCellVal(temp, cd->row, cd->col, 0);
+			if(queuePtr != NULL) updateQueuedPeers(temp, queuePtr, cd->row, cd->col);
+			cd->val = 0;
+		}
+
+		if(cd->posValsCount == 0) {	/* all possible values were tried - return to cell's father */
+			if(queuePtr != NULL) {	/* the cell is empty again */
+				bq_insert(queuePtr, cd->row*N + cd->col, possibleVals(temp, cd->row, cd->col, &possible));
+			}
+			cd = pop(&stack);
+			if(cd == NULL) break;
+			continue;
+		}
+
+		/* try the smallest possible value that wasn't tried yet */
+		cd->val = cand_next(&cd->possible,0);
+		cand_remove(&cd->possible, cd->val);
+		cd->posValsCount--;
+		placeCellVal(temp, cd->row, cd->col, cd->val);
+		if(queuePtr != NULL) updateQueuedPeers(temp, queuePtr, cd->row, cd->col);
+		cd->trailMark = prop.trailSize;
+		isConsistent = propagate(temp, &prop);
+		if(queuePtr != NULL) dequeueCells(temp, queuePtr, prop.trail, cd->trailMark, prop.trailSize);
+
+		if(!isConsistent) {							/* dead end - try the next value */
+			continue;
+		}
+		if(temp->cellsDisplayed == N*N) {			/* the board is solved */
+			counter++;
+			if(limit != NO_LIMIT && counter >= limit) break;
+			continue;
+		}
+		father = cd;
+		cd = push(&stack);							/* Try to solve the rest of the board by calling next cell*/
+		cd->row = father->row; cd->col = father->col;
+		getNextCellCordinates(temp, queuePtr, order, cd); /* there is an empty cell, as the board isn't full */
+		initCell(temp, cd);
+	}
+
+	if(queuePtr != NULL) {
+		bq_free(queuePtr);
+	}
+	freePropagation(&prop);
+	freeStack(&stack);
+	return counter;
+}
+
+
+
+/********************** Propagation Private methods *******************/
+
+/*
+ * Allocates the scratch space used by the propagation engine for boards of the same size as a board,
+ * and lists the cells of every unit.
+ *
+ * Propagation*		prop		-	Said scratch space.
+ * Board* 			boardPtr	-	A pointer to a board.
+ */
+void initPropagation(Propagation* prop, Board* boardPtr) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	unit, k, row, col;
+
+	prop->cands = (Candidates*)malloc(N*N * sizeof(Candidates));
+	prop->units = (unsigned int*)malloc(3*N*N * sizeof(unsigned int));
+	prop->trail = (unsigned int*)malloc(N*N * sizeof(unsigned int));
+	if(prop->cands == NULL || prop->units == NULL || prop->trail == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	for(unit = 0; unit < 3*N; unit++) {
+		for(k = 0; k < N; k++) {
+			getUnitCell(boardPtr, unit, k, &row, &col);
+			prop->units[unit*N + k] = row*N + col;
+		}
+	}
+	prop->trailSize = 0;
+}
+
+
+/*
+ * Frees the scratch space used by the propagation engine.
+ *
+ * Propagation*		prop	-	Said scratch space.
+ */
+void freePropagation(Propagation* prop) {
+	free(prop->cands);
+	free(prop->units);
+	free(prop->trail);
+}
+
+
+/*
+ * Calculates the coordinates of the k'th cell of a unit.
+ * Units 0 to N-1 are the rows, N to 2N-1 are the columns and 2N to 3N-1 are the blocks (see getBlockIndex()).
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * unsigned int		unit		-	Unit index (between 0 and 3N-1).
+ * unsigned int		k			-	Index of the cell in the unit (between 0 and N-1).
+ * unsigned int*	row			-	A pointer to the variable on which the row will be stored at.
+ * unsigned int*	col			-	A pointer to the variable on which the column will be stored at.
+ */
+void getUnitCell(Board* boardPtr, unsigned int unit, unsigned int k, unsigned int* row, unsigned int* col) {
+	unsigned int	m = boardPtr->m, n = boardPtr->n;
+	unsigned int	N = m*n;
+
+	if(unit < N) {			/* row */
+		*row = unit;
+		*col = k;
+	}
+	else if(unit < 2*N) {	/* column */
+		*row = k;
+		*col = unit - N;
+	}
+	else {					/* block */
+		unit -= 2*N;
+		*row = (unit/m)*m + k/n;
+		*col = (unit%m)*n + k%n;
+	}
+}
+
+
+/*
+ * Returns the set of values used by a unit (see getUnitCell()).
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * unsigned int		unit		-	Unit index (between 0 and 3N-1).
+ */
+Candidates* getUnitUsed(Board* boardPtr, unsigned int unit) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+
+	if(unit < N) {
+		return &boardPtr->rowsUsed[unit];
+	}
+	if(unit < 2*N) {
+		return &boardPtr->colsUsed[unit - N];
+	}
+	return &boardPtr->blocksUsed[unit - 2*N];
+}
+
+
+/*
+ * Assigns a value to an empty cell during the propagation, records it in the trail,
+ * and removes the value from the candidates of all the cells in its row, column and block.
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * Propagation*		prop		-	The propagation scratch space.
+ * unsigned int		row			-	Row number (between 0 and N-1).
+ * unsigned int 	col			-	Column number (between 0 and N-1).
+ * unsigned int		val			-	The value (one of the candidates of the cell).
+ */
+void assignCandidate(Board* boardPtr, Propagation* prop, unsigned int row, unsigned int col, unsigned int val) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int*	rowCells = &prop->units[row*N];
+	unsigned int*	colCells = &prop->units[(N + col)*N];
+	unsigned int*	blockCells = &prop->units[(2*N + getBlockIndex(boardPtr, row, col))*N];
+	unsigned int	k;
+
+	placeCellVal(boardPtr, row, col, val);
+	prop->trail[prop->trailSize++] = row*N + col;
+	cand_clear(&prop->cands[row*N + col]);
+
+	for(k = 0; k < N; k++) {
+		cand_remove(&prop->cands[rowCells[k]], val);
+		cand_remove(&prop->cands[colCells[k]], val);
+		cand_remove(&prop->cands[blockCells[k]], val);
+	}
+}
+
+
+/*
+ * Removes a set of values from the candidates of a cell.
+ * Returns TRUE iff at least one of the values was a candidate of the cell.
+ *
+ * Propagation*		prop	-	The propagation scratch space.
+ * unsigned int		cell	-	The cell (row*N+col).
+ * Candidates*		values	-	The values to remove.
+ */
+unsigned int removeCandidates(Propagation* prop, unsigned int cell, Candidates* values) {
+	Candidates		common = prop->cands[cell];
+
+	cand_intersect(&common, values);
+	if(cand_count(&common) == 0) {
+		return FALSE;
+	}
+	cand_subtract(&prop->cands[cell], values);
+	return TRUE;
+}
+
+
+/*
+ * Naked singles - assigns every empty cell which has a single candidate.
+ * Returns TRUE if a cell was assigned, FALSE if not, and -1 if an empty cell has no candidates (a contradiction).
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * Propagation*		prop		-	The propagation scratch space.
+ */
+int nakedSingles(Board* boardPtr, Propagation* prop) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	row, col, count;
+	int				changed = FALSE;
+
+	for(row = 0; row < N; row++) {
+		for(col = 0; col < N; col++) {
+			if(getCell(boardPtr, row, col)->value != 0) continue;
+			count = cand_count(&prop->cands[row*N + col]);
+			if(count == 0) {
+				return -1;
 			}
+			if(count == 1) {
+				assignCandidate(boardPtr, prop, row, col, cand_next(&prop->cands[row*N + col], 0));
+				changed = TRUE;
+			}
+		}
+	}
+	return changed;
+}
 
-			/* If Last cell */
-			if(cd-> row == N-1 && cd->col == N-1) {
-				/* If cell is already filled- any board who lead
-				 * to this cell is solvable with one solution.
-				 * Else, cell is empty. any board who lead
-				 * to this cell is solvable with posValsCount solutions.
-				 * (the special case of unsolvable board will return 0) */
-				if(cd->orig_cell->value != 0 )
-					cd->counter = 1;
-				else
-					cd->counter = cd->posValsCount;
-				/* return to cell's father by popping */
-				free(cd->possible);
-				cd->possible = NULL;
-				if(isEmpty(root)) break;
-				pop(&root,&cd);
-				continue;
+
+/*
+ * Hidden singles - for each unit, assigns every missing value which is a candidate of a single cell of the unit.
+ * Returns TRUE if a cell was assigned, FALSE if not, and -1 if a missing value has no possible cell in a unit (a contradiction).
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * Propagation*		prop		-	The propagation scratch space.
+ */
+int hiddenSingles(Board* boardPtr, Propagation* prop) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	unit, k, val;
+	unsigned int*	cells;
+	Candidates		once, twice, common, missing;
+	int				changed = FALSE;
+
+	for(unit = 0; unit < 3*N; unit++) {
+		cells = &prop->units[unit*N];
+		/* once - values which are candidates of at least one cell, twice - of at least two cells */
+		cand_clear(&once);
+		cand_clear(&twice);
+		for(k = 0; k < N; k++) {
+			common = once;
+			cand_intersect(&common, &prop->cands[cells[k]]);
+			cand_union(&twice, &common);
+			cand_union(&once, &prop->cands[cells[k]]);
+		}
+
+		/* every value missing from the unit must have a possible cell */
+		cand_fill(&missing, N);
+		cand_subtract(&missing, getUnitUsed(boardPtr, unit));
+		cand_subtract(&missing, &once);
+		if(cand_count(&missing) > 0) {
+			return -1;
+		}
+
+		cand_subtract(&once, &twice); /* values which are candidates of exactly one cell */
+		for(val = cand_next(&once, 0); val != 0; val = cand_next(&once, val)) {
+			for(k = 0; k < N; k++) {
+				/* the cell may have been assigned another value meanwhile */
+				if(cand_contains(&prop->cands[cells[k]], val)) {
+					assignCandidate(boardPtr, prop, cells[k]/N, cells[k]%N, val);
+					changed = TRUE;
+					break;
+				}
 			}
+		}
+	}
+	return changed;
+}
 
-			/* Not the last cell- 2 cases: */
 
-			/* Case 1: if cell is already filled  - for each legal board that will be
-			 * Accepted by filling the next cells, there will be 1 solution */
-			if(cd->orig_cell->value != 0 ) {
-				if(cd->first_time){ /*1st time we meet this cell--> push it */
-					push(&root,&cd);
-					getNextCellCordinates(&cd,N);
+/*
+ * Locked candidates - for each line (row or column) and block that intersect:
+ * 	Pointing	:	values of the block which are candidates only inside the intersection, are removed from the rest of the line.
+ * 	Claiming	:	values of the line which are candidates only inside the intersection, are removed from the rest of the block.
+ * Returns TRUE if a candidate was removed, FALSE if not.
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * Propagation*		prop		-	The propagation scratch space.
+ */
+int lockedCandidates(Board* boardPtr, Propagation* prop) {
+	unsigned int	m = boardPtr->m, n = boardPtr->n;
+	unsigned int	N = m*n;
+	unsigned int	line, seg, segSize, block, k;
+	unsigned int	*lineCells, *blockCells;
+	unsigned int	inBlock[MAX_VALUES], onLine[MAX_VALUES];	/* is the k'th cell of the line in the block / of the block on the line */
+	Candidates		inter, lineRest, blockRest, pointing, claiming;
+	int				changed = FALSE;
+
+	for(line = 0; line < 2*N; line++) {
+		lineCells = &prop->units[line*N];
+		/* a row crosses m blocks (n cells in each), a column crosses n blocks (m cells in each) */
+		segSize = (line < N) ? n : m;
+		for(seg = 0; seg < N/segSize; seg++) {
+			block = (line < N) ? (line/m)*m + seg : seg*m + (line-N)/n;
+			blockCells = &prop->units[(2*N + block)*N];
+			for(k = 0; k < N; k++) {
+				inBlock[k] = (k/segSize == seg);
+				onLine[k] = (line < N) ? (k/n == line%m) : (k%n == (line-N)%n);
+			}
+
+			/* candidates of the intersection, of the rest of the line and of the rest of the block */
+			cand_clear(&inter);
+			cand_clear(&lineRest);
+			cand_clear(&blockRest);
+			for(k = 0; k < N; k++) {
+				cand_union(inBlock[k] ? &inter : &lineRest, &prop->cands[lineCells[k]]);
+				if(!onLine[k]) {
+					cand_union(&blockRest, &prop->cands[blockCells[k]]);
 				}
-				else{				/* 2st time we meet the cell--> pop it */
-					free(cd->possible);
-					cd->possible = NULL;
-					if(isEmpty(root)) break;
-					pop(&root,&cd);
+			}
+
+			pointing = inter;
+			cand_subtract(&pointing, &blockRest);
+			claiming = inter;
+			cand_subtract(&claiming, &lineRest);
+			if(cand_count(&pointing) == 0 && cand_count(&claiming) == 0) continue;
+
+			for(k = 0; k < N; k++) {
+				if(!inBlock[k]) {
+					changed |= removeCandidates(prop, lineCells[k], &pointing);
 				}
-				continue;
+				if(!onLine[k]) {
+					changed |= removeCandidates(prop, blockCells[k], &claiming);
+				}
+			}
+		}
+	}
+	return changed;
+}
+
+
+/*
+ * Propagates a board - applies naked singles, hidden singles and locked candidates repeatedly, until none of them
+ * changes the board (a fixpoint). The values assigned are forced, so they are common to all the solutions of the board.
+ * The assigned cells are appended to the trail (see undoPropagation()).
+ * Returns FALSE iff a contradiction was found (the board has no solution), TRUE otherwise.
+ *
+ * pre: board does not contain erroneous values.
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * Propagation*		prop		-	The propagation scratch space.
+ */
+unsigned int propagate(Board* boardPtr, Propagation* prop) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	row, col;
+	int				changed;
+
+	/* the candidates of the empty cells are the values that are not used by their row, column and block */
+	for(row = 0; row < N; row++) {
+		for(col = 0; col < N; col++) {
+			if(getCell(boardPtr, row, col)->value != 0) {
+				cand_clear(&prop->cands[row*N + col]);
+			}
+			else {
+				possibleVals(boardPtr, row, col, &prop->cands[row*N + col]);
 			}
+		}
+	}
+
+	do { /* cheaper rules first */
+		if(boardPtr->cellsDisplayed == N*N) { /* solved - nothing left to propagate */
+			return TRUE;
+		}
+		changed = nakedSingles(boardPtr, prop);
+		if(changed == FALSE) {
+			changed = hiddenSingles(boardPtr, prop);
+		}
+		if(changed == FALSE) {
+			changed = lockedCandidates(boardPtr, prop);
+		}
+		if(changed == -1) {
+			return FALSE;
+		}
+	} while(changed);
+	return TRUE;
+}
+
+
+/*
+ * Clears the cells assigned by the propagation after a given point of the trail (in reverse order),
+ * and shortens the trail to that point. The cleared entries are kept in the trail array until overwritten.
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * Propagation*		prop		-	The propagation scratch space.
+ * unsigned int		mark		-	The trail size to return to.
+ */
+void undoPropagation(Board* boardPtr, Propagation* prop, unsigned int mark) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	cell;
+
+	while(prop->trailSize > mark) {
+		cell = prop->trail[--prop->trailSize];
+		placeCellVal(boardPtr, cell/N, cell%N, 0);
+	}
+}
+
+
+
+/********************** Parallel counting Private methods *******************/
+
+/*
+ * Counts the solutions of a propagated board on the calling thread, by the backend of the method set by setCountingMethod().
+ *
+ * Board* 			temp	-	A pointer a temp board.
+ * unsigned int		limit	-	The maximal number of solutions to count (NO_LIMIT to count all of them).
+ */
+unsigned int sequentialCount(Board* temp, unsigned int limit) {
+	return backends[countingMethod].count(temp, limit);
+}
 
-			/* Case 2: cell is empty */
-			for(; cd->k < N; (cd->k)++){ 			/* for all N values for this cell:*/
-				if(cd->possible[cd->k]) {			/* if a possible value:  */
-					cd->sug_cell->value = (cd->k)+1;/* assign it */
-					push(&root,&cd);				/* Try to solve the rest of the board by calling next cell*/
-					getNextCellCordinates(&cd,N);
-					goto nextCell; 					/* label who lead to the next cell*/
+
+/*
+ * Returns a copy of the values of a board's cells (values[row*N+col] is the value of cell[row][col]).
+ * This is a task of the parallel counting - the subtree of the search that starts at this board.
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ */
+unsigned char* saveValues(Board* boardPtr) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	row, col;
+	unsigned char*	values;
+
+	values = (unsigned char*)malloc(N*N * sizeof(unsigned char));
+	if(values == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	for(row = 0; row < N; row++) {
+		for(col = 0; col < N; col++) {
+			values[row*N + col] = (unsigned char)getCell(boardPtr, row, col)->value;
+		}
+	}
+	return values;
+}
+
+
+/*
+ * Sets a board to contain exactly the values of a task (see saveValues()).
+ *
+ * Board* 			boardPtr	-	A pointer to a board.
+ * unsigned char*	values		-	The values of the cells.
+ */
+void loadValues(Board* boardPtr, unsigned char* values) {
+	unsigned int	N = boardPtr->m * boardPtr->n;
+	unsigned int	row, col;
+
+	nullifyBoard(boardPtr);
+	for(row = 0; row < N; row++) {
+		for(col = 0; col < N; col++) {
+			if(values[row*N + col] != 0) {
+				placeCellVal(boardPtr, row, col, values[row*N + col]);
+			}
+		}
+	}
+}
+
+
+/*
+ * Splits the search tree of a propagated board into subtrees (tasks) at shallow depth, breadth first:
+ * a task is replaced by its children - a task for each possible value of its cell with the least possible values
+ * (propagated), until there are at least target tasks or no tasks are left.
+ * Children which are solved boards are counted in counter instead, and children with a contradiction are dropped.
+ * Returns the array of the tasks (see saveValues()), and stores their number in numTasks.
+ *
+ * Board* 			temp		-	A pointer a temp board (its contents are changed).
+ * unsigned int		target		-	The wanted number of tasks.
+ * unsigned int*	numTasks	-	A pointer to the variable on which the number of tasks will be stored at.
+ * unsigned int*	counter		-	A pointer to the solutions counter.
+ */
+unsigned char** splitSearch(Board* temp, unsigned int target, unsigned int* numTasks, unsigned int* counter) {
+	unsigned int	N = temp->m * temp->n;
+	unsigned int	head = 0, size = 0, capacity = 2*target;
+	unsigned int	row, col, bestRow = 0, bestCol = 0, count, bestCount, val, mark, i;
+	unsigned char**	tasks;
+	Propagation		prop;
+	Candidates		possible;
+
+	tasks = (unsigned char**)malloc(capacity * sizeof(unsigned char*));
+	if(tasks == NULL) {printf("Error: malloc has failed\n");exit(1);}
+	initPropagation(&prop, temp);
+	tasks[size++] = saveValues(temp);
+
+	/* tasks[head] to tasks[size-1] are waiting to be split or counted */
+	while(head < size && size - head < target) {
+		loadValues(temp, tasks[head]);
+		free(tasks[head++]);
+
+		/* the empty cell with the least possible values (the board isn't full) */
+		bestCount = N+1;
+		for(row = 0; row < N; row++) {
+			for(col = 0; col < N; col++) {
+				if(getCell(temp, row, col)->value != 0) continue;
+				count = possibleVals(temp, row, col, &possible);
+				if(count < bestCount) {
+					bestCount = count;
+					bestRow = row;
+					bestCol = col;
 				}
 			}
-			free(cd->possible);
-			cd->possible = NULL;
-			if(isEmpty(root)) break;
-			pop(&root,&cd);
-			nextCell: continue;
-	}
-	while(TRUE);
-	counter = cd->counter;
-	free(cd);
+		}
+
+		possibleVals(temp, bestRow, bestCol, &possible);
+		for(val = cand_next(&possible, 0); val != 0; val = cand_next(&possible, val)) {
+			placeCellVal(temp, bestRow, bestCol, val);
+			mark = prop.trailSize;
+			if(propagate(temp, &prop)) {
+				if(temp->cellsDisplayed == N*N) {	/* solved */
+					(*counter)++;
+				}
+				else {
+					if(size == capacity) {
+						capacity *= 2;
+						tasks = (unsigned char**)realloc(tasks, capacity * sizeof(unsigned char*));
+						if(tasks == NULL) {printf("Error: realloc has failed\n");exit(1);}
+					}
+					tasks[size++] = saveValues(temp);
+				}
+			}
+			undoPropagation(temp, &prop, mark);
+			placeCellVal(temp, bestRow, bestCol, 0);
+		}
+	}
+
+	/* move the remaining tasks to the beginning of the array */
+	for(i = head; i < size; i++) {
+		tasks[i - head] = tasks[i];
+	}
+	*numTasks = size - head;
+	freePropagation(&prop);
+	return tasks;
+}
+
+
+/*
+ * Counts the solutions of a single task on the board of the worker running it (a TaskFunction, see ThreadPool.h).
+ *
+ * void*			task		-	The task (see saveValues()). freed here.
+ * unsigned int		worker		-	The index of the worker running the task.
+ * void*			context		-	A pointer to the ParallelCount shared by the workers.
+ */
+void countTask(void* task, unsigned int worker, void* context) {
+	ParallelCount*	shared = (ParallelCount*)context;
+
+	loadValues(&shared->boards[worker], (unsigned char*)task);
+	free(task);
+	shared->counters[worker] += sequentialCount(&shared->boards[worker], NO_LIMIT);
+}
+
+
+/*
+ * Counts the solutions of a propagated board in parallel - the search tree is split into subtrees at shallow depth,
+ * which are counted by a work-stealing pool of threads. Each worker has its own board, and its own counter.
+ *
+ * Board* 			temp		-	A pointer a temp board (its contents are changed).
+ * unsigned int		numWorkers	-	Number of threads.
+ */
+unsigned int parallelCount(Board* temp, unsigned int numWorkers) {
+	unsigned int	counter = 0;
+	unsigned int	numTasks, i;
+	unsigned char**	tasks;
+	ParallelCount	shared;
+	ThreadPool		pool;
+
+	tasks = splitSearch(temp, numWorkers * TASKS_PER_THREAD, &numTasks, &counter);
+	if(numTasks == 0) {
+		free(tasks);
+		return counter;
+	}
+
+	shared.boards = (Board*)calloc(numWorkers, sizeof(Board));	/* zeroed - initializeBoard() frees non-NULL boards */
+	shared.counters = (unsigned int*)calloc(numWorkers, sizeof(unsigned int));
+	if(shared.boards == NULL || shared.counters == NULL) {printf("Error: malloc has failed\n");exit(1);}
+	for(i = 0; i < numWorkers; i++) {
+		initializeBoard(&shared.boards[i], temp->m, temp->n);
+	}
+
+	/* deal the tasks to the workers - idle workers will steal the rest */
+	tp_init(&pool, numWorkers, countTask, &shared);
+	for(i = 0; i < numTasks; i++) {
+		tp_submit(&pool, i % numWorkers, tasks[i]);
+	}
+	tp_run(&pool);
+	tp_free(&pool);
+
+	for(i = 0; i < numWorkers; i++) {
+		counter += shared.counters[i];
+		freeBoard(&shared.boards[i]);
+	}
+	free(shared.boards);
+	free(shared.counters);
+	free(tasks);
 	return counter;
 }
 
+
+
+/********************** Backtracking backend Private methods *******************/
+
+/*
+ * Solves a board with the exhaustive backtracking (in MRV order), stopping at the first solution,
+ * and updates its solution board. return TRUE iff board is solvable (if not - the solution board is not changed).
+ *
+ * Board*	boardPtr	-	A pointer to a board.
+ * Board*	solBoardPtr	-	A pointer to the solution board (of the same size).
+ */
+int backtrackingSolve(Board* boardPtr, Board* solBoardPtr) {
+	Board	tempBoard = {'\0'};
+	int		isSolvable;
+
+	initializeBoard(&tempBoard, boardPtr->m, boardPtr->n);
+	copyBoard(boardPtr, &tempBoard);
+	isSolvable = (exhaustiveBacktracking(&tempBoard, MRV_ORDER, 1) == 1);
+	if(isSolvable) { /* the search stopped at the first solution - the temp board holds it */
+		copyBoard(&tempBoard, solBoardPtr);
+	}
+	freeBoard(&tempBoard);
+	return isSolvable;
+}
+
+
+/*
+ * Calculates the number of solutions for a board with the exhaustive backtracking (in MRV order).
+ *
+ * Board* 			temp	-	A pointer a temp board (changed by the search).
+ * unsigned int		limit	-	The maximal number of solutions to count (NO_LIMIT to count all of them).
+ */
+unsigned int backtrackingCount(Board* temp, unsigned int limit) {
+	return exhaustiveBacktracking(temp, MRV_ORDER, limit);
+}
+
+
+
+/********************** Kernels backend Private methods *******************/
+
+/*
+ * Calculates the number of solutions for a board with the kernel of its geometry (see Kernels.h) -
+ * boards of the common geometries (9x9, 16x16 and 25x25). Other boards are counted with dancing links.
+ *
+ * Board* 			temp	-	A pointer a temp board.
+ * unsigned int		limit	-	The maximal number of solutions to count (NO_LIMIT to count all of them).
+ */
+unsigned int kernelsCount(Board* temp, unsigned int limit) {
+	if(hasKernel(temp->m, temp->n)) {
+		return kernelNumSolutions(temp, limit);
+	}
+	return dlxNumSolutions(temp, limit);
+}
+
+
+
+/********************** generate() Private methods *******************/
+
+/*
+ * Fills an empty board with a random solved board.
+ * The solved board is a fixed pattern - cell[r][c] = ((r%m)*n + r/m + c)%N + 1 - where the rows of each band
+ * (m rows of blocks) and the columns of each stack (n columns of blocks) are shifted by different amounts,
+ * so every row, column and block has all the values. It is then shuffled by the changes that keep a board solved:
+ * the values are permuted, the rows are permuted within their bands and the bands are permuted,
+ * the columns are permuted within their stacks and the stacks are permuted, and a board of square blocks may be transposed.
+ * Takes O(N^2) time - there is no search, so it can't fail.
+ *
+ * pre: the board is empty
+ *
+ * Board*	boardPtr	-	A pointer to a game board.
+ */
+void fillRandomGrid(Board* boardPtr) {
+	unsigned int	m = boardPtr->m, n = boardPtr->n;
+	unsigned int	N = m*n;
+	unsigned int	*values, *rows, *cols, *bands, *stacks;
+	unsigned int	row, col, r, c, i, transpose;
+
+	values = (unsigned int*)malloc((3*N + n + m)*sizeof(unsigned int));
+	if(values == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	rows = values + N;		/* rows[row] - the row of the pattern which is placed at row */
+	cols = rows + N;		/* cols[col] - the column of the pattern which is placed at col */
+	bands = cols + N;		/* the n bands, then the m stacks */
+	stacks = bands + n;
+
+	randomPermutation(values, N);
+	randomPermutation(bands, n);
+	randomPermutation(stacks, m);
+	for(i = 0; i < n; i++) { /* the rows of the i'th band come from band bands[i] of the pattern */
+		randomPermutation(rows + i*m, m);
+		for(row = i*m; row < (i+1)*m; row++) {
+			rows[row] += bands[i]*m;
+		}
+	}
+	for(i = 0; i < m; i++) { /* the columns of the i'th stack come from stack stacks[i] of the pattern */
+		randomPermutation(cols + i*n, n);
+		for(col = i*n; col < (i+1)*n; col++) {
+			cols[col] += stacks[i]*n;
+		}
+	}
+	transpose = (m == n) && (rand()%2 == 1);
+
+	for(row = 0; row < N; row++) {
+		for(col = 0; col < N; col++) {
+			r = transpose ? cols[col] : rows[row];
+			c = transpose ? rows[row] : cols[col];
+			setCellVal(boardPtr, row, col, values[((r%m)*n + r/m + c)%N] + 1);
+		}
+	}
+	free(values);
+}
@@ -7,20 +7,61 @@
  * 	2.isBoardComplete() :	Returns TRUE if all cells are filled on a game board and are not erroneous.
  * 	3.autofill() 		:	Fill cells which contain exactly a single legal value
  * 	4.numSolutions()   :	Calculates the number of solutions for the current board.
- * 	5.generate() 		:	Try to generate x cells at gameBoardPtr board.
- * 						   	try to solve with ilp(result at "solution_board" so we copy it to gameBoardPtr board).
- * 						   	finally deleting cells values until only y values left.
+ * 	   						using the method set by setCountingMethod() (the geometry kernels by default).
+ * 	5.generate() 		:	Generates a puzzle - fills gameBoardPtr board with a random solved board,
+ * 						   	then deletes cells values until only y values left.
+ * 	6.setCountingMethod() :	Sets the method used by numSolutions().
+ * 	7.getCountingMethod() :	Returns the method used by numSolutions().
+ * 	8.countSolutions()	:	Calculates the number of solutions for the current board, up to a given limit.
+ * 	   						Large boards are counted in parallel (see setNumThreads()).
+ * 	9.setNumThreads()	:	Sets the number of threads used for counting solutions.
+ * 	10.getNumThreads()	:	Returns the number of threads used for counting solutions.
+ * 	11.setSolvingMethod() :	Sets the method used by validate() for solving boards.
+ * 	12.getSolvingMethod() :	Returns the method used by validate() for solving boards.
+ * 	13.solveBoard()		:	Solves a board with the solving method, and updates its solution board.
+ * 	14.selectSolverBackend() :	Selects the solving (and counting) method by the name of its backend.
+ * 	15.getBackendName()	:	Returns the name of the backend of a method.
  *
  */
 
 #include "Game.h"
 
+/* Methods for counting solutions (BACKTRACKING, DANCING_LINKS, KERNELS) and solving boards (BACKTRACKING, DANCING_LINKS, ILP) */
+#define BACKTRACKING		0	/* exhaustive backtracking (implemented using a stack) */
+#define DANCING_LINKS		1	/* Algorithm X on the exact cover model of the board (see DLX.h) */
+#define ILP					2	/* integer linear programming with Gurobi (see ILP_Solver.h) */
+#define KERNELS				3	/* the kernel of the board's geometry (see Kernels.h), dancing links for other geometries */
+
+#define NUM_BACKENDS		4	/* the number of methods above */
+
+#define NO_LIMIT			0	/* countSolutions() limit - count all the solutions */
+
+#define SOLVER_ENV_VARIABLE	"SUDOKU_SOLVER"	/* the environment variable that selects the backend at startup */
+
+/*
+ * A solver backend - the operations of one of the methods above over a board.
+ * The backends are registered in a table of Solver.c, indexed by their method, and are selected
+ * by setSolvingMethod() and setCountingMethod() (or by name, with selectSolverBackend()).
+ * A backend finds a single solution of a board with solve() (if it can solve), and counts its solutions with count() (if it can count).
+ * A backend may also keep state between the solves of the game's board (see validate()), with solveGame().
+ */
+typedef struct solver_backend_t {
+	char*			name;							/* the name of the backend (as given to the solver command) */
+	int				(*solve)(Board*, Board*);		/* solves a board and updates its solution board - TRUE iff solvable (-1 on failure) (NULL if the backend can't solve) */
+	unsigned int	(*count)(Board*, unsigned int);	/* counts the solutions of a board up to a limit (NULL if the backend can't count) */
+	int				(*solveGame)(Board*, Board*);	/* solve() for the game's board, reusing the previous solves (NULL - solve() is used) */
+} SolverBackend;
+
 
 
 /*
  * Checks if the current configuration of the game board is solvable.
  * If solvable and some cells' val field != sol_val - update relevant sol_val's.
- * Returns TRUE iff current configuration of game board is solvable.
+ * Returns TRUE iff current configuration of game board is solvable (-1 on Gurobi failure).
+ * The board is propagated first - the method set by setSolvingMethod() (dancing links by default) is used only
+ * if the propagation neither solves the board nor finds a contradiction.
+ * The backend of the method solves the board with its solveGame() operation, if it has one (see SolverBackend).
+ * The solution of the game board is cached - it is not solved again while the last solution still fits it (see isSolutionCurrent()).
  *
  *	Pre: board is not erroneous	(Checked in MainAux.c)
  * Board*	boardPtr		-	A pointer a game board.
@@ -48,7 +89,8 @@ void			autofill(Board*);
 
 
 /*
- * Calculates the number of solutions for the current board
+ * Calculates the number of solutions for the current board,
+ * using the method set by setCountingMethod() (the geometry kernels by default).
  *
  * Board*	boardPtr		-	A pointer a game board.
  */
@@ -56,13 +98,101 @@ unsigned int	numSolutions(Board*);
 
 
 /*
- * Try to generate x cells at gameBoardPtr board.
- * try to solve with ilp(result at "solution_board" so we copy it to gameBoardPtr board).
- * finally deleting cells values until only y values left.
+ * Generates a puzzle at gameBoardPtr board: fills it with a random solved board, which is also kept as
+ * the solution of the game, then deletes cells values until only y values left.
+ * The solved board is built directly, without a solver - the time is O(N^2). x is ignored.
+ * Returns TRUE (a solved board always exists).
  *
  * pre: we are in EDIT mode			(Checked in MainAux.c)
+ * pre: the board is empty			(Checked in MainAux.c)
  * pre: x, y to are int 			(Checked in MainAux.c)
  * pre :x, y have legal coordinates (Checked in MainAux.c)
  *
  */
 unsigned int	generate(Board* ,int, int);
+
+
+/*
+ * Sets the method used by numSolutions() for counting solutions.
+ *
+ * unsigned int	method	-	BACKTRACKING, DANCING_LINKS or KERNELS (a backend that can count).
+ */
+void			setCountingMethod(unsigned int);
+
+
+/*
+ * Returns the method used by numSolutions() for counting solutions.
+ */
+unsigned int	getCountingMethod();
+
+
+/*
+ * Calculates the number of solutions for the current board, using the method set by setCountingMethod().
+ * Stops counting once limit solutions were found, and returns limit - so a limit of 2 is enough
+ * to tell an unsolvable board (0), a board with a unique solution (1) and a board with more than one solution (2).
+ *
+ * Board*			boardPtr	-	A pointer a game board.
+ * unsigned int		limit		-	The maximal number of solutions to count (NO_LIMIT to count all of them).
+ */
+unsigned int	countSolutions(Board*, unsigned int);
+
+
+/*
+ * Sets the number of threads used by numSolutions() for counting solutions.
+ * When counting all the solutions of a board with many empty cells, the search tree is split into subtrees
+ * which are counted in parallel by a work-stealing pool of threads (see ThreadPool.h).
+ *
+ * unsigned int	threads	-	Number of threads (1 - no parallel counting, 0 - one thread per online processor).
+ */
+void			setNumThreads(unsigned int);
+
+
+/*
+ * Returns the number of threads used by numSolutions() for counting solutions (0 - one thread per online processor).
+ */
+unsigned int	getNumThreads();
+
+
+/*
+ * Sets the method used by validate() for solving boards (and so by the hint, validate, generate and save commands).
+ *
+ * unsigned int	method	-	BACKTRACKING, DANCING_LINKS or ILP.
+ */
+void			setSolvingMethod(unsigned int);
+
+
+/*
+ * Returns the method used by validate() for solving boards.
+ */
+unsigned int	getSolvingMethod();
+
+
+/*
+ * Solves a board with the method set by setSolvingMethod(), and updates its solution board.
+ * Unlike validate(), the board is not propagated first, and the solution board of the game is not used.
+ * Returns TRUE iff the board is solvable (if not - the solution board is not changed), -1 on Gurobi failure.
+ *
+ * pre: the board has no erroneous cells
+ *
+ * Board*	boardPtr	-	A pointer to a board.
+ * Board*	solBoardPtr	-	A pointer to the solution board (of the same size).
+ */
+int				solveBoard(Board*, Board*);
+
+
+/*
+ * Selects the backend with a given name ("backtracking", "dlx", "ilp" or "kernels") for solving boards if it can solve,
+ * and for counting solutions if it can count (ILP can't count and the kernels can't solve - the other method is then unchanged).
+ * Returns TRUE iff there is a backend with this name.
+ *
+ * char*	name	-	The name of the backend.
+ */
+int				selectSolverBackend(char*);
+
+
+/*
+ * Returns the name of the backend of a solving or counting method.
+ *
+ * unsigned int	method	-	BACKTRACKING, DANCING_LINKS, ILP or KERNELS.
+ */
+char*			getBackendName(unsigned int);
@@ -1,7 +1,11 @@
 /*---Stack.h---
  * An implement of a stack for exhaustive-Backtracking in solver.c
  * Besides stack structure, also contains "info_t" -
- * A structure to represent the info in a stack node
+ * A structure to represent the info in a stack frame
+ *
+ * The stack is a single array of frames, allocated once in initStack() - the search depth is bounded by
+ * the number of cells, so there are no allocations while searching. The frames are used in place:
+ * push() and pop() return a pointer to the frame at the top of the stack.
  */
 
 #include <stdio.h>
@@ -13,33 +17,30 @@
 
 
 /*------------------- stack structure-----------------------------*/
-/* A structure to represent the info in a stack node*/
+/* A structure to represent the info in a stack frame*/
 typedef struct info_t {
 	unsigned int	row,col;		/* cell's row and col */
-	unsigned int	k;				/* for empty cell only, the current iteration of possible values */
-	unsigned int* 	possible;		/* calloc in init_cell(), free() in while loop */
-	unsigned int	posValsCount;	/* Decreased by 1 in push() */
-	unsigned int	counter;		/* increased in pop() */
-	Cell*			orig_cell;
-	Cell*			sug_cell;
-	unsigned int    first_time;		/* set to TRUE in push(), set to FALSE in push() */
+	Candidates	 	possible;		/* the possible values that weren't tried yet. calculated in initCell() */
+	unsigned int	posValsCount;	/* number of values in possible */
+	unsigned int	val;			/* the value currently assigned to the cell (0 if none) */
+	unsigned int	trailMark;		/* the propagation trail size before val was assigned (see exhaustiveBacktracking()) */
 } info;
 
-/* A structure to represent a stack node*/
-struct StackNode
-{
-	info cell_info;
-    struct StackNode* next;
-};
+/* A structure to represent the stack */
+typedef struct stack_t {
+	info*			frames;		/* frames[0] is the bottom of the stack, frames[size-1] is the top */
+	unsigned int	size;		/* number of frames in the stack */
+	unsigned int	capacity;	/* maximal number of frames */
+} Stack;
 
-int isEmpty(struct StackNode *);
-
-void push(struct StackNode** , info** );
-
-void pop(struct StackNode** , info** );
+void initStack(Stack* , unsigned int );
 
+void freeStack(Stack* );
 
+int isEmpty(Stack* );
 
+info* push(Stack* );
 
+info* pop(Stack* );
 
 #endif /* STACK_H_ */
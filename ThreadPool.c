@@ -0,0 +1,317 @@
+/*---ThreadPool.c---
+ * An implementation of a work-stealing thread pool, used by Solver.c in order to count the solutions of
+ * the subtrees of the search in parallel.
+ *
+ * A. Private functions:
+ * 	1. pushBottom()		:	Adds a task to the bottom of a deque.
+ * 	2. popBottom()		:	Removes and returns the task at the bottom of a deque (the owner's end).
+ * 	3. stealTop()		:	Removes and returns the task at the top of a deque (the thieves' end).
+ * 	4. findTask()		:	Finds a task for a worker - from its own deque, or stolen from another worker.
+ * 	5. workerMain()		:	The main loop of a worker thread.
+ *
+ * B. Public functions:
+ * 	1. tp_init()		:	Initializes a pool of workers, with empty deques.
+ * 	2. tp_free()		:	Frees all allocated space used by a pool.
+ * 	3. tp_submit()		:	Adds a task to the deque of a worker.
+ * 	4. tp_run()			:	Runs all the tasks of a pool (and the tasks they submit) on the worker threads.
+ * 	5. tp_numCores()	:	Returns the number of online processors.
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for sysconf() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "ThreadPool.h"
+
+#define	TRUE	1
+#define FALSE	0
+
+#define INITIAL_CAPACITY	64	/* initial number of tasks in a deque */
+
+
+/* The argument of a worker thread */
+typedef struct worker_arg_t {
+	ThreadPool*		pool;
+	unsigned int	worker;
+} WorkerArg;
+
+
+/********** Private method declarations **********/
+
+void	pushBottom(WorkDeque*, void*);
+void*	popBottom(WorkDeque*);
+void*	stealTop(WorkDeque*);
+void*	findTask(ThreadPool*, unsigned int);
+void*	workerMain(void*);
+
+/******* End of private method declarations ******/
+
+
+
+/************************* Public methods *************************/
+
+/*
+ * Initializes a pool of workers, with empty deques.
+ *
+ * ThreadPool*		pool		-	Said pool.
+ * unsigned int		numWorkers	-	Number of worker threads (at least 1).
+ * TaskFunction		function	-	The function that runs each task.
+ * void*			context		-	Passed to function on each call.
+ */
+void tp_init(ThreadPool* pool, unsigned int numWorkers, TaskFunction function, void* context) {
+	unsigned int	i;
+
+	pool->deques = (WorkDeque*)malloc(numWorkers * sizeof(WorkDeque));
+	if(pool->deques == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	for(i = 0; i < numWorkers; i++) {
+		pool->deques[i].tasks = (void**)malloc(INITIAL_CAPACITY * sizeof(void*));
+		if(pool->deques[i].tasks == NULL) {
+			printf("Error: malloc has failed\n");
+			exit(1);
+		}
+		pool->deques[i].top = 0;
+		pool->deques[i].bottom = 0;
+		pool->deques[i].capacity = INITIAL_CAPACITY;
+		pthread_mutex_init(&pool->deques[i].lock, NULL);
+	}
+	pool->numWorkers = numWorkers;
+	pool->function = function;
+	pool->context = context;
+	pool->pending = 0;
+	pool->submitted = 0;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->changed, NULL);
+}
+
+
+/*
+ * Frees all allocated space used by a pool (the tasks themselves are not freed).
+ *
+ * ThreadPool*		pool	-	Said pool.
+ */
+void tp_free(ThreadPool* pool) {
+	unsigned int	i;
+
+	for(i = 0; i < pool->numWorkers; i++) {
+		pthread_mutex_destroy(&pool->deques[i].lock);
+		free(pool->deques[i].tasks);
+	}
+	free(pool->deques);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->changed);
+}
+
+
+/*
+ * Adds a task to the bottom of the deque of a worker.
+ * May be called before tp_run(), or by a task while it is running (with the index of the worker running it).
+ *
+ * ThreadPool*		pool	-	Said pool.
+ * unsigned int		worker	-	The index of the worker (between 0 and numWorkers-1).
+ * void*			task	-	The task.
+ */
+void tp_submit(ThreadPool* pool, unsigned int worker, void* task) {
+	/* count the task before it can be taken, so pending can't reach 0 too early */
+	pthread_mutex_lock(&pool->lock);
+	pool->pending++;
+	pthread_mutex_unlock(&pool->lock);
+
+	pushBottom(&pool->deques[worker], task);
+
+	/* wake up idle workers */
+	pthread_mutex_lock(&pool->lock);
+	pool->submitted++;
+	pthread_cond_broadcast(&pool->changed);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+
+/*
+ * Runs all the tasks of a pool (and the tasks they submit) on numWorkers threads,
+ * and returns when all of them are done.
+ * The calling thread is used as worker 0.
+ *
+ * ThreadPool*		pool	-	Said pool.
+ */
+void tp_run(ThreadPool* pool) {
+	pthread_t*		threads;
+	WorkerArg*		args;
+	unsigned int	i;
+
+	threads = (pthread_t*)malloc(pool->numWorkers * sizeof(pthread_t));
+	args = (WorkerArg*)malloc(pool->numWorkers * sizeof(WorkerArg));
+	if(threads == NULL || args == NULL) {
+		printf("Error: malloc has failed\n");
+		exit(1);
+	}
+	for(i = 0; i < pool->numWorkers; i++) {
+		args[i].pool = pool;
+		args[i].worker = i;
+	}
+
+	for(i = 1; i < pool->numWorkers; i++) {
+		if(pthread_create(&threads[i], NULL, workerMain, &args[i]) != 0) {
+			printf("Error: pthread_create has failed\n");
+			exit(1);
+		}
+	}
+	workerMain(&args[0]);
+	for(i = 1; i < pool->numWorkers; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+	free(args);
+}
+
+
+/*
+ * Returns the number of online processors (at least 1).
+ */
+unsigned int tp_numCores() {
+	long	cores = sysconf(_SC_NPROCESSORS_ONLN);
+	return (cores > 0) ? (unsigned int)cores : 1;
+}
+
+/********************** End of public methods *********************/
+
+
+
+/************************* Private methods *************************/
+
+/*
+ * Adds a task to the bottom of a deque (grows the deque if needed).
+ *
+ * WorkDeque*	deque	-	Said deque.
+ * void*		task	-	The task.
+ */
+void pushBottom(WorkDeque* deque, void* task) {
+	unsigned int	i, size;
+
+	pthread_mutex_lock(&deque->lock);
+	if(deque->bottom == deque->capacity) {
+		size = deque->bottom - deque->top;
+		if(size * 2 <= deque->capacity) {	/* more than half is free at the top - move the tasks back */
+			for(i = 0; i < size; i++) {
+				deque->tasks[i] = deque->tasks[deque->top + i];
+			}
+		}
+		else {								/* grow */
+			deque->capacity *= 2;
+			deque->tasks = (void**)realloc(deque->tasks, deque->capacity * sizeof(void*));
+			if(deque->tasks == NULL) {
+				printf("Error: realloc has failed\n");
+				exit(1);
+			}
+			for(i = 0; i < size; i++) {
+				deque->tasks[i] = deque->tasks[deque->top + i];
+			}
+		}
+		deque->top = 0;
+		deque->bottom = size;
+	}
+	deque->tasks[deque->bottom++] = task;
+	pthread_mutex_unlock(&deque->lock);
+}
+
+
+/*
+ * Removes and returns the task at the bottom of a deque, or NULL if the deque is empty.
+ *
+ * WorkDeque*	deque	-	Said deque.
+ */
+void* popBottom(WorkDeque* deque) {
+	void*	task = NULL;
+
+	pthread_mutex_lock(&deque->lock);
+	if(deque->bottom > deque->top) {
+		task = deque->tasks[--deque->bottom];
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return task;
+}
+
+
+/*
+ * Removes and returns the task at the top of a deque, or NULL if the deque is empty.
+ *
+ * WorkDeque*	deque	-	Said deque.
+ */
+void* stealTop(WorkDeque* deque) {
+	void*	task = NULL;
+
+	pthread_mutex_lock(&deque->lock);
+	if(deque->bottom > deque->top) {
+		task = deque->tasks[deque->top++];
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return task;
+}
+
+
+/*
+ * Finds a task for a worker - from the bottom of its own deque, or else stolen from the top of another worker's deque.
+ * Returns NULL if all the deques are empty.
+ *
+ * ThreadPool*		pool	-	Said pool.
+ * unsigned int		worker	-	The index of the worker.
+ */
+void* findTask(ThreadPool* pool, unsigned int worker) {
+	unsigned int	i;
+	void*			task;
+
+	task = popBottom(&pool->deques[worker]);
+	for(i = 1; task == NULL && i < pool->numWorkers; i++) { /* start with the next worker, to spread the thefts */
+		task = stealTop(&pool->deques[(worker + i) % pool->numWorkers]);
+	}
+	return task;
+}
+
+
+/*
+ * The main loop of a worker thread - runs tasks until all the tasks of the pool are done.
+ *
+ * void*	arg		-	A pointer to the WorkerArg of the worker.
+ */
+void* workerMain(void* arg) {
+	ThreadPool*		pool = ((WorkerArg*)arg)->pool;
+	unsigned int	worker = ((WorkerArg*)arg)->worker;
+	unsigned int	submitted;
+	void*			task;
+
+	while(TRUE) {
+		pthread_mutex_lock(&pool->lock);
+		submitted = pool->submitted;
+		pthread_mutex_unlock(&pool->lock);
+
+		task = findTask(pool, worker);
+		if(task != NULL) {
+			pool->function(task, worker, pool->context);
+			pthread_mutex_lock(&pool->lock);
+			pool->pending--;
+			if(pool->pending == 0) { /* all done - wake up the idle workers so they can exit */
+				pthread_cond_broadcast(&pool->changed);
+			}
+			pthread_mutex_unlock(&pool->lock);
+			continue;
+		}
+
+		/* no task was found - wait until a new task is submitted, or all the tasks are done */
+		pthread_mutex_lock(&pool->lock);
+		while(pool->pending > 0 && pool->submitted == submitted) {
+			pthread_cond_wait(&pool->changed, &pool->lock);
+		}
+		if(pool->pending == 0) {
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return NULL;
+}
+
+/********************** End of private methods *********************/
@@ -0,0 +1,100 @@
+/*---ThreadPool.h---
+ * An implementation of a work-stealing thread pool, used by Solver.c in order to count the solutions of
+ * the subtrees of the search in parallel.
+ *
+ * Each worker thread has its own deque of tasks. A worker takes tasks from the bottom of its own deque (the most
+ * recently added first), and when it runs out of tasks - it steals tasks from the top of the other workers' deques.
+ * A task may submit new tasks (to the deque of the worker running it). tp_run() returns when all tasks are done.
+ *
+ * Functions:
+ * 	1. tp_init()		:	Initializes a pool of workers, with empty deques.
+ * 	2. tp_free()		:	Frees all allocated space used by a pool.
+ * 	3. tp_submit()		:	Adds a task to the deque of a worker.
+ * 	4. tp_run()			:	Runs all the tasks of a pool (and the tasks they submit) on the worker threads.
+ * 	5. tp_numCores()	:	Returns the number of online processors.
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <pthread.h>
+
+
+/*
+ * A function that runs a task.
+ *
+ * void*			task		-	The task.
+ * unsigned int		worker		-	The index of the worker running the task (between 0 and numWorkers-1).
+ * void*			context		-	The context given to tp_init().
+ */
+typedef void (*TaskFunction)(void*, unsigned int, void*);
+
+
+/* A structure for the deque of tasks of a single worker */
+typedef struct work_deque_t {
+	void**			tasks;		/* tasks[top] to tasks[bottom-1] are in the deque */
+	unsigned int	top;
+	unsigned int	bottom;
+	unsigned int	capacity;
+	pthread_mutex_t	lock;
+} WorkDeque;
+
+
+/* A structure for a work-stealing thread pool */
+typedef struct thread_pool_t {
+	WorkDeque*		deques;		/* deques[i] - the deque of worker i */
+	unsigned int	numWorkers;
+	TaskFunction	function;	/* runs each task */
+	void*			context;	/* passed to function */
+	unsigned int	pending;	/* number of tasks submitted and not done yet */
+	unsigned int	submitted;	/* number of tasks submitted so far (used to detect new tasks while waiting) */
+	pthread_mutex_t	lock;		/* protects pending and submitted */
+	pthread_cond_t	changed;	/* signaled when a task is submitted, or when all the tasks are done */
+} ThreadPool;
+
+
+/*
+ * Initializes a pool of workers, with empty deques.
+ *
+ * ThreadPool*		pool		-	Said pool.
+ * unsigned int		numWorkers	-	Number of worker threads (at least 1).
+ * TaskFunction		function	-	The function that runs each task.
+ * void*			context		-	Passed to function on each call.
+ */
+void			tp_init(ThreadPool*, unsigned int, TaskFunction, void*);
+
+
+/*
+ * Frees all allocated space used by a pool (the tasks themselves are not freed).
+ *
+ * ThreadPool*		pool	-	Said pool.
+ */
+void			tp_free(ThreadPool*);
+
+
+/*
+ * Adds a task to the bottom of the deque of a worker.
+ * May be called before tp_run(), or by a task while it is running (with the index of the worker running it).
+ *
+ * ThreadPool*		pool	-	Said pool.
+ * unsigned int		worker	-	The index of the worker (between 0 and numWorkers-1).
+ * void*			task	-	The task.
+ */
+void			tp_submit(ThreadPool*, unsigned int, void*);
+
+
+/*
+ * Runs all the tasks of a pool (and the tasks they submit) on numWorkers threads,
+ * and returns when all of them are done.
+ *
+ * ThreadPool*		pool	-	Said pool.
+ */
+void			tp_run(ThreadPool*);
+
+
+/*
+ * Returns the number of online processors (at least 1).
+ */
+unsigned int	tp_numCores();
+
+#endif /* THREAD_POOL_H_ */
@@ -4,6 +4,8 @@
  * Then, it waits for user input. The input is parsed (by using "Parser.h) as a command.
  * If it is a legal command, it is executed (by using "MainAux.h").
  * The function ends when exit command entered as an input
+ * If the program is run with command line arguments, it runs in batch mode instead (by using "Batch.h").
+ * In both modes, the solver backend may be selected by the SUDOKU_SOLVER environment variable (by using "Solver.h").
  */
 
 #include <stdio.h>
@@ -14,15 +16,24 @@
 #include "MainAux.h"
 #include "Parser.h"
 #include "Game.h"
+#include "Batch.h"
+#include "Solver.h"
 
 
-int main() {
+int main(int argc, char* argv[]) {
 	unsigned int    isValidCommand;
 	unsigned int	exitProgram = FALSE;
 	unsigned int	executedSuccessfully;
 	char            input[MAX_INPUT_LENGTH] = {'\0'};
 	int				command[4] = { 0 };
 	char			path[MAX_INPUT_LENGTH];
+	char*			solverName = getenv(SOLVER_ENV_VARIABLE);
+	if(solverName != NULL && !selectSolverBackend(solverName)) { /* the default backend is used */
+		printf("Error: unknown solver %s, the solvers are backtracking, dlx, ilp and kernels\n", solverName);
+	}
+	if(argc > 1) { /* batch mode - no prompts */
+		return batchMain(argc, argv);
+	}
 	SP_BUFF_SET()
 	srand(time(NULL));
 	setGameMode(INIT);